@@ -0,0 +1,113 @@
+/**
+ * @file audio_clock.c
+ * @brief Implementation of the sample-frame clock derived from the I2S DMA.
+ *
+ * The on_sent ISR adds each finished buffer to a frame counter and records when it happened.
+ * Readers interpolate from that point with esp_timer, so a timestamp taken between two
+ * interrupts still resolves to a single frame. On the TDM backplane BCLK/WS come from the
+ * master, so every module's clock advances in lockstep.
+ */
+
+#include "audio_clock.h"
+#include <stdatomic.h>
+#include "esp_attr.h"
+#include "esp_timer.h"
+
+/** @brief Update sequence counter; odd while the ISR is updating the fields below. */
+static atomic_uint clock_seq = 0;
+
+/** @brief Frames sent by the DMA, in whole buffers. */
+static volatile uint32_t clock_frames = 0;
+
+/** @brief esp_timer time (µs) at which clock_frames last advanced. */
+static volatile int64_t clock_time_us = 0;
+
+/** @brief Sample rate (Hz). */
+static uint32_t clock_sample_rate = 44100;
+
+/**
+ * @brief Sets the sample rate used to interpolate between DMA buffers.
+ * @param sample_rate The audio sample rate in Hz.
+ */
+void audio_clock_init(uint32_t sample_rate)
+{
+    clock_sample_rate = sample_rate;
+}
+
+/**
+ * @brief Advances the clock by one sent DMA buffer. Called from the I2S on_sent ISR.
+ * @param frames Frames in the buffer that finished sending.
+ */
+IRAM_ATTR void audio_clock_advance_from_isr(uint32_t frames)
+{
+    unsigned seq = atomic_load_explicit(&clock_seq, memory_order_relaxed);
+    atomic_store_explicit(&clock_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    clock_frames += frames;
+    clock_time_us = esp_timer_get_time();
+    atomic_store_explicit(&clock_seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Reads the frame count and its timestamp as one consistent pair.
+ * @param time_us Receives the esp_timer time of the last advance.
+ * @return uint32_t Frame count.
+ */
+static uint32_t audio_clock_read(int64_t *time_us)
+{
+    unsigned seq;
+    uint32_t frames;
+    do
+    {
+        seq = atomic_load_explicit(&clock_seq, memory_order_acquire);
+        frames = clock_frames;
+        *time_us = clock_time_us;
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&clock_seq, memory_order_relaxed) != seq);
+    return frames;
+}
+
+/**
+ * @brief Returns the number of frames sent by the DMA, counted in whole buffers.
+ * @return uint32_t Frame count (wraps).
+ */
+uint32_t audio_clock_frames(void)
+{
+    int64_t time_us;
+    return audio_clock_read(&time_us);
+}
+
+/**
+ * @brief Returns the frame being sent right now, interpolated inside the current DMA buffer.
+ * @return uint32_t Frame index (wraps).
+ */
+uint32_t audio_clock_now(void)
+{
+    return audio_clock_frame_at(esp_timer_get_time());
+}
+
+/**
+ * @brief Converts an esp_timer time into the frame that was being sent at that moment.
+ * @param time_us esp_timer time (µs), no later than now.
+ * @return uint32_t Frame index (wraps).
+ */
+uint32_t audio_clock_frame_at(int64_t time_us)
+{
+    int64_t advance_us;
+    uint32_t frames = audio_clock_read(&advance_us);
+    // Negative for a time before the last advance, which counts back into the previous buffer
+    int64_t offset = (time_us - advance_us) * clock_sample_rate / 1000000;
+    // A late interrupt must not let the estimate run into the next buffer
+    if (offset > CONFIG_OSC_I2S_DMA_FRAME_NUM - 1)
+        offset = CONFIG_OSC_I2S_DMA_FRAME_NUM - 1;
+    return frames + (int32_t)offset;
+}
+
+/**
+ * @brief Returns the timestamp for a parameter event issued now.
+ * @return uint32_t audio_clock_now() plus AUDIO_CLOCK_LATENCY_FRAMES.
+ */
+uint32_t audio_clock_event_frame(void)
+{
+    return audio_clock_now() + AUDIO_CLOCK_LATENCY_FRAMES;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file audio_clock.h
+ * @brief Header file for the sample-frame clock derived from the I2S DMA, used to timestamp parameter events.
+ */
+
+#ifndef AUDIO_CLOCK_H
+#define AUDIO_CLOCK_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/**
+ * @brief Frames between an event being timestamped and it being heard.
+ *
+ * Every DMA buffer may already be queued ahead of the block being rendered, so an event
+ * stamped this far past the current frame always lands in a block that has not been
+ * rendered yet and is applied exactly on its frame. Without CONFIG_OSC_I2S_ZERO_COPY the
+ * audio task renders one period further ahead, while its copy waits for a free buffer.
+ */
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+#define AUDIO_CLOCK_LATENCY_FRAMES (CONFIG_OSC_I2S_DMA_DESC_NUM * CONFIG_OSC_I2S_DMA_FRAME_NUM)
+#else
+#define AUDIO_CLOCK_LATENCY_FRAMES ((CONFIG_OSC_I2S_DMA_DESC_NUM + 1) * CONFIG_OSC_I2S_DMA_FRAME_NUM)
+#endif
+
+/**
+ * @brief Sets the sample rate used to interpolate between DMA buffers.
+ * @param sample_rate The audio sample rate in Hz.
+ */
+void audio_clock_init(uint32_t sample_rate);
+
+/**
+ * @brief Advances the clock by one sent DMA buffer. Called from the I2S on_sent ISR.
+ * @param frames Frames in the buffer that finished sending.
+ */
+void audio_clock_advance_from_isr(uint32_t frames);
+
+/**
+ * @brief Returns the number of frames sent by the DMA, counted in whole buffers.
+ * @return uint32_t Frame count (wraps).
+ */
+uint32_t audio_clock_frames(void);
+
+/**
+ * @brief Returns the frame being sent right now, interpolated inside the current DMA buffer.
+ * @return uint32_t Frame index (wraps).
+ */
+uint32_t audio_clock_now(void);
+
+/**
+ * @brief Converts an esp_timer time into the frame that was being sent at that moment.
+ * @param time_us esp_timer time (µs), no later than now.
+ * @return uint32_t Frame index (wraps).
+ *
+ * Lets an ISR record just the time of an event and leave the conversion to a task.
+ */
+uint32_t audio_clock_frame_at(int64_t time_us);
+
+/**
+ * @brief Returns the timestamp for a parameter event issued now.
+ * @return uint32_t audio_clock_now() plus AUDIO_CLOCK_LATENCY_FRAMES.
+ */
+uint32_t audio_clock_event_frame(void);
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file boot_profile.c
+ * @brief Implementation of the boot stage timestamps.
+ */
+
+#include "boot_profile.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+/** @brief Log tag. */
+static const char *TAG = "BOOT";
+
+/** @brief Stage names for the log. */
+static const char *const stage_names[BOOT_STAGE_COUNT] = {
+    "app_main",
+    "audio started",
+    "first sample",
+    "state loaded",
+    "i2c ready",
+    "ui ready",
+};
+
+/** @brief esp_timer time of each stage, 0 until reached. */
+static volatile int64_t stage_times[BOOT_STAGE_COUNT];
+
+/**
+ * @brief Records the time a stage was reached; only the first call per stage counts.
+ * @param stage The stage.
+ */
+void boot_profile_mark(boot_stage_t stage)
+{
+    if (stage_times[stage] == 0)
+        stage_times[stage] = esp_timer_get_time();
+}
+
+/**
+ * @brief Returns the time a stage was reached.
+ * @param stage The stage.
+ * @return int64_t esp_timer time (µs since startup), or 0 if not reached yet.
+ */
+int64_t boot_profile_time(boot_stage_t stage)
+{
+    return stage_times[stage];
+}
+
+/**
+ * @brief Logs the time of every stage reached so far.
+ */
+void boot_profile_log(void)
+{
+    for (int stage = 0; stage < BOOT_STAGE_COUNT; stage++)
+    {
+        if (stage_times[stage])
+            ESP_LOGI(TAG, "%-14s %8lld us", stage_names[stage], (long long)stage_times[stage]);
+        else
+            ESP_LOGI(TAG, "%-14s        -", stage_names[stage]);
+    }
+}
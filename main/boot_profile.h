@@ -0,0 +1,43 @@
+/**
+ * @file boot_profile.h
+ * @brief Header file for the boot stage timestamps used to track power-on-to-first-sample time.
+ */
+
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Boot stages, in the order the staged boot reaches them.
+ */
+typedef enum
+{
+    BOOT_STAGE_APP_MAIN,      ///< app_main() entered
+    BOOT_STAGE_AUDIO_STARTED, ///< I2S running and audio tasks created, on default parameters
+    BOOT_STAGE_FIRST_SAMPLE,  ///< First block handed to the I2S DMA
+    BOOT_STAGE_STATE_LOADED,  ///< Saved parameters applied
+    BOOT_STAGE_I2C_READY,     ///< I2C slave answering the controller
+    BOOT_STAGE_UI_READY,      ///< Display and encoder initialized
+    BOOT_STAGE_COUNT
+} boot_stage_t;
+
+/**
+ * @brief Records the time a stage was reached; only the first call per stage counts.
+ * @param stage The stage.
+ */
+void boot_profile_mark(boot_stage_t stage);
+
+/**
+ * @brief Returns the time a stage was reached.
+ * @param stage The stage.
+ * @return int64_t esp_timer time (µs since startup), or 0 if not reached yet.
+ */
+int64_t boot_profile_time(boot_stage_t stage);
+
+/**
+ * @brief Logs the time of every stage reached so far.
+ */
+void boot_profile_log(void);
+
+#endif
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Script to generate the pitch-to-phase-increment lookup tables for the oscillator module.
+Writes pitch_tables.h with const Q32 phase increments for MIDI notes 0-127 and Q30
+fine-tune ratios for -100 to +100 cents, so the firmware never calls powf() for pitch.
+"""
+
+import sys
+
+MIDI_A4 = 69
+A4_FREQ = 440.0
+FINE_MIN_CENTS = -100
+FINE_MAX_CENTS = 100
+CENTS_RATIO_FRAC_BITS = 30
+
+
+def note_increment(note, sample_rate):
+    """
+    Computes the Q32 phase increment per sample of a MIDI note.
+
+    Args:
+        note (int): MIDI note number (0-127).
+        sample_rate (int): Audio sample rate in Hz.
+
+    Returns:
+        int: Phase increment, one full cycle per 2^32.
+    """
+    freq = A4_FREQ * 2.0 ** ((note - MIDI_A4) / 12.0)
+    return int(round(freq / sample_rate * 2 ** 32))
+
+
+def cents_ratio(cents):
+    """
+    Computes the Q30 frequency ratio of a fine-tune offset.
+
+    Args:
+        cents (int): Offset in cents.
+
+    Returns:
+        int: Frequency ratio scaled by 2^30.
+    """
+    return int(round(2.0 ** (cents / 1200.0) * 2 ** CENTS_RATIO_FRAC_BITS))
+
+
+def format_table(values, per_line=6):
+    """
+    Formats integers as the body of a C array initializer.
+
+    Args:
+        values (list): Values to format.
+        per_line (int): Number of values per line.
+
+    Returns:
+        str: Indented initializer lines.
+    """
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(f"{v}u" for v in values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def generate_pitch_tables_h(output_h_path, sample_rate):
+    """
+    Generates pitch_tables.h.
+
+    Args:
+        output_h_path (str): Path of the header to write.
+        sample_rate (int): Audio sample rate in Hz the increments are computed for.
+    """
+    note_incs = [note_increment(n, sample_rate) for n in range(128)]
+    ratios = [cents_ratio(c) for c in range(FINE_MIN_CENTS, FINE_MAX_CENTS + 1)]
+    content = f"""/**
+ * @file pitch_tables.h
+ * @brief Pitch-to-phase-increment lookup tables, generated by generate_pitch_tables.py. Do not edit.
+ */
+
+#ifndef PITCH_TABLES_H
+#define PITCH_TABLES_H
+
+#include <stdint.h>
+
+/** @brief Sample rate the phase increments were generated for (Hz). */
+#define PITCH_TABLE_SAMPLE_RATE {sample_rate}
+
+/** @brief Lowest fine-tune offset in cents_ratio_table. */
+#define PITCH_TABLE_FINE_MIN {FINE_MIN_CENTS}
+
+/** @brief Highest fine-tune offset in cents_ratio_table. */
+#define PITCH_TABLE_FINE_MAX {FINE_MAX_CENTS}
+
+/** @brief Fractional bits of the cents_ratio_table entries. */
+#define PITCH_TABLE_RATIO_BITS {CENTS_RATIO_FRAC_BITS}
+
+/** @brief Q32 phase increment per sample for each MIDI note (0–127). */
+static const uint32_t note_inc_table[128] = {{
+{format_table(note_incs)}
+}};
+
+/** @brief Q{CENTS_RATIO_FRAC_BITS} frequency ratio for each fine-tune offset, indexed by cents - PITCH_TABLE_FINE_MIN. */
+static const uint32_t cents_ratio_table[{len(ratios)}] = {{
+{format_table(ratios)}
+}};
+
+#endif
+"""
+    with open(output_h_path, 'w') as f:
+        f.write(content)
+    print(f"Generated pitch tables: {output_h_path}")
+
+
+def main():
+    """
+    Main function to generate pitch_tables.h.
+
+    Args:
+        sys.argv[1] (str): Path to output pitch_tables.h.
+        sys.argv[2] (str): Audio sample rate in Hz.
+    """
+    if len(sys.argv) != 3:
+        print("Usage: generate_pitch_tables.py <output_h_path> <sample_rate>")
+        sys.exit(1)
+
+    generate_pitch_tables_h(sys.argv[1], int(sys.argv[2]))
+
+
+if __name__ == "__main__":
+    main()
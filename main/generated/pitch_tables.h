@@ -0,0 +1,87 @@
+/**
+ * @file pitch_tables.h
+ * @brief Pitch-to-phase-increment lookup tables, generated by generate_pitch_tables.py. Do not edit.
+ */
+
+#ifndef PITCH_TABLES_H
+#define PITCH_TABLES_H
+
+#include <stdint.h>
+
+/** @brief Sample rate the phase increments were generated for (Hz). */
+#define PITCH_TABLE_SAMPLE_RATE 44100
+
+/** @brief Lowest fine-tune offset in cents_ratio_table. */
+#define PITCH_TABLE_FINE_MIN -100
+
+/** @brief Highest fine-tune offset in cents_ratio_table. */
+#define PITCH_TABLE_FINE_MAX 100
+
+/** @brief Fractional bits of the cents_ratio_table entries. */
+#define PITCH_TABLE_RATIO_BITS 30
+
+/** @brief Q32 phase increment per sample for each MIDI note (0–127). */
+static const uint32_t note_inc_table[128] = {
+    796254u, 843601u, 893765u, 946911u, 1003217u, 1062871u,
+    1126073u, 1193033u, 1263974u, 1339134u, 1418763u, 1503127u,
+    1592507u, 1687203u, 1787529u, 1893821u, 2006434u, 2125742u,
+    2252146u, 2386065u, 2527948u, 2678268u, 2837526u, 3006254u,
+    3185015u, 3374406u, 3575058u, 3787642u, 4012867u, 4251485u,
+    4504291u, 4772130u, 5055896u, 5356535u, 5675051u, 6012507u,
+    6370030u, 6748811u, 7150117u, 7575285u, 8025735u, 8502970u,
+    9008582u, 9544261u, 10111792u, 10713070u, 11350103u, 12025015u,
+    12740059u, 13497623u, 14300233u, 15150569u, 16051469u, 17005939u,
+    18017165u, 19088521u, 20223584u, 21426141u, 22700205u, 24050030u,
+    25480119u, 26995246u, 28600467u, 30301139u, 32102938u, 34011878u,
+    36034330u, 38177043u, 40447168u, 42852281u, 45400411u, 48100060u,
+    50960238u, 53990491u, 57200933u, 60602278u, 64205876u, 68023757u,
+    72068660u, 76354085u, 80894335u, 85704563u, 90800821u, 96200119u,
+    101920476u, 107980983u, 114401866u, 121204555u, 128411753u, 136047513u,
+    144137319u, 152708170u, 161788671u, 171409126u, 181601643u, 192400238u,
+    203840952u, 215961966u, 228803732u, 242409110u, 256823506u, 272095026u,
+    288274639u, 305416341u, 323577341u, 342818251u, 363203285u, 384800477u,
+    407681904u, 431923931u, 457607465u, 484818220u, 513647012u, 544190053u,
+    576549277u, 610832681u, 647154683u, 685636503u, 726406571u, 769600953u,
+    815363807u, 863847862u, 915214929u, 969636441u, 1027294024u, 1088380105u,
+    1153098554u, 1221665363u,
+};
+
+/** @brief Q30 frequency ratio for each fine-tune offset, indexed by cents - PITCH_TABLE_FINE_MIN. */
+static const uint32_t cents_ratio_table[201] = {
+    1013477326u, 1014062903u, 1014648818u, 1015235071u, 1015821663u, 1016408594u,
+    1016995865u, 1017583474u, 1018171423u, 1018759712u, 1019348341u, 1019937309u,
+    1020526618u, 1021116268u, 1021706258u, 1022296589u, 1022887262u, 1023478275u,
+    1024069630u, 1024661327u, 1025253365u, 1025845746u, 1026438469u, 1027031534u,
+    1027624942u, 1028218693u, 1028812787u, 1029407224u, 1030002005u, 1030597130u,
+    1031192598u, 1031788410u, 1032384567u, 1032981067u, 1033577913u, 1034175104u,
+    1034772639u, 1035370520u, 1035968746u, 1036567318u, 1037166236u, 1037765499u,
+    1038365109u, 1038965066u, 1039565369u, 1040166019u, 1040767016u, 1041368360u,
+    1041970052u, 1042572091u, 1043174479u, 1043777214u, 1044380297u, 1044983729u,
+    1045587510u, 1046191639u, 1046796118u, 1047400946u, 1048006123u, 1048611650u,
+    1049217527u, 1049823754u, 1050430331u, 1051037258u, 1051644537u, 1052252166u,
+    1052860146u, 1053468478u, 1054077161u, 1054686196u, 1055295582u, 1055905321u,
+    1056515412u, 1057125855u, 1057736652u, 1058347801u, 1058959303u, 1059571159u,
+    1060183368u, 1060795931u, 1061408847u, 1062022118u, 1062635743u, 1063249723u,
+    1063864058u, 1064478747u, 1065093792u, 1065709192u, 1066324947u, 1066941059u,
+    1067557526u, 1068174350u, 1068791530u, 1069409066u, 1070026959u, 1070645210u,
+    1071263817u, 1071882782u, 1072502105u, 1073121785u, 1073741824u, 1074362221u,
+    1074982976u, 1075604090u, 1076225563u, 1076847394u, 1077469586u, 1078092136u,
+    1078715047u, 1079338317u, 1079961947u, 1080585938u, 1081210289u, 1081835001u,
+    1082460074u, 1083085508u, 1083711303u, 1084337460u, 1084963979u, 1085590860u,
+    1086218103u, 1086845708u, 1087473676u, 1088102007u, 1088730701u, 1089359758u,
+    1089989179u, 1090618963u, 1091249112u, 1091879624u, 1092510500u, 1093141742u,
+    1093773347u, 1094405318u, 1095037654u, 1095670355u, 1096303422u, 1096936855u,
+    1097570653u, 1098204818u, 1098839349u, 1099474247u, 1100109512u, 1100745144u,
+    1101381143u, 1102017509u, 1102654243u, 1103291345u, 1103928816u, 1104566654u,
+    1105204861u, 1105843437u, 1106482382u, 1107121695u, 1107761379u, 1108401432u,
+    1109041854u, 1109682647u, 1110323810u, 1110965344u, 1111607248u, 1112249523u,
+    1112892169u, 1113535186u, 1114178575u, 1114822336u, 1115466468u, 1116110973u,
+    1116755850u, 1117401100u, 1118046723u, 1118692719u, 1119339088u, 1119985830u,
+    1120632946u, 1121280436u, 1121928300u, 1122576538u, 1123225151u, 1123874139u,
+    1124523502u, 1125173240u, 1125823353u, 1126473842u, 1127124707u, 1127775947u,
+    1128427564u, 1129079558u, 1129731928u, 1130384676u, 1131037800u, 1131691302u,
+    1132345181u, 1132999438u, 1133654074u, 1134309087u, 1134964479u, 1135620249u,
+    1136276399u, 1136932927u, 1137589835u,
+};
+
+#endif
@@ -0,0 +1,288 @@
+/**
+ * @file i2c_link.c
+ * @brief Implementation of the I2C slave link on the callback-based i2c_slave driver.
+ *
+ * The receive callback selects the register a write names and copies the write into a queue
+ * read by the parser task. The request callback answers the read itself, while the controller
+ * is clock-stretched: the response buffers are kept current by whoever owns the data (the
+ * parameter store republishes REG_COMMON_PARAM_DUMP on every change), so it only copies the
+ * selected one into the TX FIFO. Both callbacks run in the same ISR, so a read always sees the
+ * selection of the write before it.
+ *
+ * The TX FIFO holds I2C_LINK_TX_FIFO_LEN bytes. A longer response (the parameter dump) has its
+ * remainder handed to the link task, which passes it to the driver while the first bytes are
+ * still being clocked out.
+ */
+
+#include "i2c_link.h"
+#include <string.h>
+#include "freertos/queue.h"
+#include "driver/i2c_slave.h"
+#include "hal/i2c_ll.h"
+#include "soc/i2c_struct.h"
+#include "soc/soc_caps.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "module_i2c_proto.h"
+#include "i2c_proto_batch.h"
+
+#if !CONFIG_I2C_ENABLE_SLAVE_DRIVER_VERSION_2
+#error "i2c_link requires CONFIG_I2C_ENABLE_SLAVE_DRIVER_VERSION_2"
+#endif
+
+/** @brief Number of transactions buffered between the ISR and the parser. */
+#define I2C_LINK_QUEUE_LEN 16
+
+/** @brief Bytes of a response the request callback writes into the hardware TX FIFO. */
+#define I2C_LINK_TX_FIFO_LEN SOC_I2C_FIFO_LEN
+
+/** @brief Log tag. */
+static const char *TAG = "I2C_LINK";
+
+/**
+ * @brief Prepared response of one readable register.
+ */
+typedef struct
+{
+    uint8_t len;                         ///< Bytes in data
+    uint8_t data[I2C_LINK_RESPONSE_MAX]; ///< Response bytes
+} i2c_link_response_t;
+
+/** @brief Readable registers, indexing response_bufs. */
+static const DRAM_ATTR uint8_t read_regs[I2C_LINK_READ_REG_COUNT] = {
+    REG_COMMON_MODULE_TYPE,
+    REG_COMMON_FIRMWARE_VERSION,
+    REG_COMMON_STATUS,
+    REG_COMMON_GET_PARAM,
+    REG_COMMON_PARAM_DUMP,
+};
+
+/** @brief Response buffers; REG_COMMON_GET_PARAM's stays empty, as it is cut from the dump. */
+static i2c_link_response_t response_bufs[I2C_LINK_READ_REG_COUNT];
+
+/** @brief Guards response_bufs and response_tail, shared between the I2C ISR and the tasks. */
+static portMUX_TYPE response_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/** @brief Index into read_regs of the register selected for the next read; I2C ISR only. */
+static uint8_t selected_reg = 0;
+
+/** @brief Parameter ID carried by the last REG_COMMON_GET_PARAM write; I2C ISR only. */
+static ParamId_t get_param_id = 0;
+
+/** @brief Part of the last response that did not fit the TX FIFO, waiting for the link task. */
+static i2c_link_response_t response_tail;
+
+/** @brief Slave device handle. */
+static i2c_slave_dev_handle_t slave_handle = NULL;
+
+/** @brief Transactions waiting for the parser. */
+static QueueHandle_t link_queue = NULL;
+
+/**
+ * @brief Returns the index of a readable register.
+ * @param reg The register.
+ * @return int Index into read_regs, or -1 if reg is not readable.
+ */
+static IRAM_ATTR int read_reg_index(uint8_t reg)
+{
+    for (int i = 0; i < I2C_LINK_READ_REG_COUNT; i++)
+    {
+        if (read_regs[i] == reg)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Copies the REG_COMMON_GET_PARAM response for get_param_id out of the dump buffer. Call with response_lock held.
+ * @param out Filled with the response: count 1 and the matching entry, or count 0 if the ID is unknown.
+ * @return uint8_t Bytes written to out.
+ */
+static IRAM_ATTR uint8_t i2c_link_get_param_response(uint8_t *out)
+{
+    const i2c_link_response_t *dump = &response_bufs[read_reg_index(REG_COMMON_PARAM_DUMP)];
+    const uint8_t *entry = dump->data + 1;
+    for (int i = 0; i < dump->data[0] && entry + I2C_PROTO_BATCH_ENTRY_LEN <= dump->data + dump->len; i++)
+    {
+        if ((entry[0] | (entry[1] << 8)) == get_param_id)
+        {
+            out[0] = 1;
+            memcpy(out + 1, entry, I2C_PROTO_BATCH_ENTRY_LEN);
+            return 1 + I2C_PROTO_BATCH_ENTRY_LEN;
+        }
+        entry += I2C_PROTO_BATCH_ENTRY_LEN;
+    }
+    out[0] = 0;
+    return 1;
+}
+
+/**
+ * @brief Reports whether the write that just completed was a general call, and clears the flag.
+ * @return bool True if the controller addressed the general call address.
+ *
+ * The driver leaves the general call interrupt disabled, so its raw bit latches on the address
+ * phase and stays set until cleared here, at the end of that same transaction. The next
+ * address phase is at least nine SCL periods later, well after the callback has run.
+ */
+static IRAM_ATTR bool i2c_link_take_general_call(void)
+{
+    if (!I2C0.int_raw.general_call_int_raw)
+        return false;
+    I2C0.int_clr.general_call_int_clr = 1;
+    return true;
+}
+
+/**
+ * @brief Receive callback, selecting the register a write names and queueing the write for the parser, tagged if it was a general call.
+ *
+ * A general call never selects a register for the next read, since the read that follows is
+ * addressed to one module.
+ * @param handle The slave device handle.
+ * @param event Received bytes.
+ * @param user_ctx Unused user context.
+ * @return bool True if a higher-priority task was woken.
+ */
+static IRAM_ATTR bool i2c_link_on_receive(i2c_slave_dev_handle_t handle, const i2c_slave_rx_done_event_data_t *event,
+                                          void *user_ctx)
+{
+    if (event->length == 0 || event->length > I2C_LINK_MSG_MAX)
+        return false;
+    i2c_link_msg_t msg;
+    msg.time_us = esp_timer_get_time();
+    msg.general_call = i2c_link_take_general_call();
+    msg.len = event->length;
+    if (!msg.general_call)
+    {
+        int i = read_reg_index(event->buffer[0]);
+        if (i >= 0)
+            selected_reg = i;
+        if (event->buffer[0] == REG_COMMON_GET_PARAM && event->length >= 3)
+            get_param_id = event->buffer[1] | (event->buffer[2] << 8);
+    }
+    memcpy(msg.data, event->buffer, event->length);
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(link_queue, &msg, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Request callback, writing the selected response into the TX FIFO while the controller is stretched.
+ *
+ * Bytes left in the FIFO by a read the controller ended early are dropped first. A response
+ * longer than the FIFO has the rest queued for the link task as an empty message.
+ * @param handle The slave device handle.
+ * @param event Unused event data.
+ * @param user_ctx Unused user context.
+ * @return bool True if a higher-priority task was woken.
+ */
+static IRAM_ATTR bool i2c_link_on_request(i2c_slave_dev_handle_t handle, const i2c_slave_request_event_data_t *event,
+                                          void *user_ctx)
+{
+    i2c_dev_t *hw = I2C_LL_GET_HW(I2C_NUM_0);
+    i2c_link_response_t resp;
+    portENTER_CRITICAL_ISR(&response_lock);
+    if (read_regs[selected_reg] == REG_COMMON_GET_PARAM)
+        resp.len = i2c_link_get_param_response(resp.data);
+    else
+        resp = response_bufs[selected_reg];
+    uint8_t head = resp.len < I2C_LINK_TX_FIFO_LEN ? resp.len : I2C_LINK_TX_FIFO_LEN;
+    response_tail.len = resp.len - head;
+    memcpy(response_tail.data, resp.data + head, response_tail.len);
+    portEXIT_CRITICAL_ISR(&response_lock);
+    i2c_ll_txfifo_rst(hw);
+    i2c_ll_write_txfifo(hw, resp.data, head);
+    if (resp.len == head)
+        return false;
+    i2c_link_msg_t msg = {.time_us = esp_timer_get_time(), .general_call = false, .len = 0};
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(link_queue, &msg, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ * @brief Passes the pending response tail to the driver, which feeds it to the TX FIFO as it drains.
+ */
+static void i2c_link_send_tail(void)
+{
+    i2c_link_response_t tail;
+    portENTER_CRITICAL(&response_lock);
+    tail = response_tail;
+    response_tail.len = 0;
+    portEXIT_CRITICAL(&response_lock);
+    uint32_t written = 0;
+    if (tail.len > 0 && (i2c_slave_write(slave_handle, tail.data, tail.len, &written, 0) != ESP_OK ||
+                         written != tail.len))
+        ESP_LOGW(TAG, "Response tail truncated (%u/%u)", (unsigned)written, tail.len);
+}
+
+/**
+ * @brief Creates the I2C slave device, answering general calls too, and registers the receive and request callbacks.
+ * @param sda_gpio SDA pin.
+ * @param scl_gpio SCL pin.
+ * @param addr 7-bit slave address.
+ */
+void i2c_link_init(int sda_gpio, int scl_gpio, uint16_t addr)
+{
+    link_queue = xQueueCreate(I2C_LINK_QUEUE_LEN, sizeof(i2c_link_msg_t));
+    i2c_slave_config_t conf = {
+        .i2c_port = I2C_NUM_0,
+        .sda_io_num = sda_gpio,
+        .scl_io_num = scl_gpio,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .send_buf_depth = I2C_LINK_RESPONSE_MAX * 2,
+        .receive_buf_depth = I2C_LINK_MSG_MAX * 2,
+        .slave_addr = addr,
+        .addr_bit_len = I2C_ADDR_BIT_LEN_7,
+        .flags.enable_internal_pullup = 1,
+        // General call (address 0) reaches every module at once for group commands; anything
+        // else sent to it is tagged and dropped by the parser
+        .flags.broadcast_en = 1,
+    };
+    ESP_ERROR_CHECK(i2c_new_slave_device(&conf, &slave_handle));
+    i2c_slave_event_callbacks_t cbs = {
+        .on_receive = i2c_link_on_receive,
+        .on_request = i2c_link_on_request,
+    };
+    ESP_ERROR_CHECK(i2c_slave_register_event_callbacks(slave_handle, &cbs, NULL));
+}
+
+/**
+ * @brief Waits for the next write from the controller.
+ *
+ * Reads are answered by the I2C ISR and never returned here; while waiting, this also sends the
+ * part of a response longer than the hardware TX FIFO, so call it from a task that runs promptly.
+ * @param msg Filled with the write.
+ * @param wait Ticks to wait.
+ * @return bool True if a write was received.
+ */
+bool i2c_link_receive(i2c_link_msg_t *msg, TickType_t wait)
+{
+    while (xQueueReceive(link_queue, msg, wait) == pdTRUE)
+    {
+        if (msg->len > 0)
+            return true;
+        i2c_link_send_tail();
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces the response buffer of a readable register. Safe to call from any task.
+ * @param reg The register; REG_COMMON_GET_PARAM has no buffer of its own.
+ * @param data Response bytes.
+ * @param len Number of bytes, at most I2C_LINK_RESPONSE_MAX.
+ * @return bool True if reg is a readable register with a response buffer.
+ */
+bool i2c_link_set_response(uint8_t reg, const uint8_t *data, uint8_t len)
+{
+    int i = read_reg_index(reg);
+    if (i < 0 || reg == REG_COMMON_GET_PARAM || len > I2C_LINK_RESPONSE_MAX)
+        return false;
+    portENTER_CRITICAL(&response_lock);
+    memcpy(response_bufs[i].data, data, len);
+    response_bufs[i].len = len;
+    portEXIT_CRITICAL(&response_lock);
+    return true;
+}
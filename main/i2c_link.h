@@ -0,0 +1,67 @@
+/**
+ * @file i2c_link.h
+ * @brief Header file for the callback-driven I2C slave link and its register map.
+ *
+ * The controller writes a register byte followed by that register's payload. A write starting
+ * with a readable register selects it, and the next read returns its response buffer. The
+ * REG_COMMON_GET_PARAM response is taken from the REG_COMMON_PARAM_DUMP one: the entry whose
+ * ID the selecting write carried, or an empty batch if there is none.
+ * Command registers and payload layouts come from module_i2c_proto.
+ */
+
+#ifndef I2C_LINK_H
+#define I2C_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+/** @brief Largest transaction the link accepts, register byte included; longer writes are dropped whole. */
+#define I2C_LINK_MSG_MAX 64
+
+/** @brief Largest response returned by a read. */
+#define I2C_LINK_RESPONSE_MAX 64
+
+/** @brief Number of readable registers with a response buffer. */
+#define I2C_LINK_READ_REG_COUNT 5
+
+/**
+ * @brief One write handed from the I2C ISR to the parser.
+ */
+typedef struct
+{
+    int64_t time_us;                ///< esp_timer time at which the write completed
+    bool general_call;              ///< Write addressed to the general call address rather than this module
+    uint8_t len;                    ///< Bytes received
+    uint8_t data[I2C_LINK_MSG_MAX]; ///< Register byte followed by its payload
+} i2c_link_msg_t;
+
+/**
+ * @brief Creates the I2C slave device, answering general calls too, and registers the receive and request callbacks.
+ * @param sda_gpio SDA pin.
+ * @param scl_gpio SCL pin.
+ * @param addr 7-bit slave address.
+ */
+void i2c_link_init(int sda_gpio, int scl_gpio, uint16_t addr);
+
+/**
+ * @brief Waits for the next write from the controller.
+ *
+ * Reads are answered by the I2C ISR and never returned here; while waiting, this also sends the
+ * part of a response longer than the hardware TX FIFO, so call it from a task that runs promptly.
+ * @param msg Filled with the write.
+ * @param wait Ticks to wait.
+ * @return bool True if a write was received.
+ */
+bool i2c_link_receive(i2c_link_msg_t *msg, TickType_t wait);
+
+/**
+ * @brief Replaces the response buffer of a readable register. Safe to call from any task.
+ * @param reg The register; REG_COMMON_GET_PARAM has no buffer of its own.
+ * @param data Response bytes.
+ * @param len Number of bytes, at most I2C_LINK_RESPONSE_MAX.
+ * @return bool True if reg is a readable register with a response buffer.
+ */
+bool i2c_link_set_response(uint8_t reg, const uint8_t *data, uint8_t len);
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * @file i2c_proto_batch.c
+ * @brief Implementation of the batched parameter payloads of the module I2C protocol.
+ */
+
+#include "i2c_proto_batch.h"
+
+/**
+ * @brief Packs a batched SET payload.
+ * @param ids Parameter IDs.
+ * @param values Parameter values, one per ID.
+ * @param count Number of entries, at most I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param buf Destination for the payload (without the register byte).
+ * @param buf_len Size of buf.
+ * @return int Payload length in bytes, or -1 if it does not fit.
+ */
+int i2c_proto_pack_set_param_batch(const ParamId_t *ids, const ParamValue_t *values, uint8_t count, uint8_t *buf,
+                                   int buf_len)
+{
+    int len = 1 + count * I2C_PROTO_BATCH_ENTRY_LEN;
+    if (count > I2C_PROTO_BATCH_MAX_PARAMS || len > buf_len)
+        return -1;
+    *buf++ = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        uint32_t value = values[i].u32;
+        *buf++ = ids[i] & 0xFF;
+        *buf++ = ids[i] >> 8;
+        *buf++ = value & 0xFF;
+        *buf++ = (value >> 8) & 0xFF;
+        *buf++ = (value >> 16) & 0xFF;
+        *buf++ = value >> 24;
+    }
+    return len;
+}
+
+/**
+ * @brief Unpacks a batched SET payload.
+ * @param buf Payload (without the register byte).
+ * @param len Payload length.
+ * @param ids Filled with the parameter IDs; room for I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param values Filled with the parameter values; room for I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param count Filled with the number of entries.
+ * @return bool True if the payload is well formed.
+ */
+bool i2c_proto_unpack_set_param_batch(const uint8_t *buf, int len, ParamId_t *ids, ParamValue_t *values,
+                                      uint8_t *count)
+{
+    if (len < 1 || buf[0] > I2C_PROTO_BATCH_MAX_PARAMS || len < 1 + buf[0] * I2C_PROTO_BATCH_ENTRY_LEN)
+        return false;
+    *count = *buf++;
+    for (uint8_t i = 0; i < *count; i++)
+    {
+        ids[i] = buf[0] | (buf[1] << 8);
+        values[i].u32 = buf[2] | (buf[3] << 8) | (buf[4] << 16) | ((uint32_t)buf[5] << 24);
+        buf += I2C_PROTO_BATCH_ENTRY_LEN;
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file i2c_proto_batch.h
+ * @brief Header file for the batched parameter payloads of the module I2C protocol.
+ *
+ * Payload layout after the register byte, all fields little-endian:
+ *   count (u8), then count entries of { ParamId_t id (u16), ParamValue_t value (u32) }.
+ * The same layout is written by REG_COMMON_SET_PARAM_BATCH and read back from
+ * REG_COMMON_GET_PARAM and REG_COMMON_PARAM_DUMP, so a dump can be replayed as a batch.
+ */
+
+#ifndef I2C_PROTO_BATCH_H
+#define I2C_PROTO_BATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "module_i2c_proto.h"
+
+#ifndef REG_COMMON_SET_PARAM_BATCH
+/** @brief Register of the batched SET command; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_SET_PARAM_BATCH 0x1A
+#endif
+
+#ifndef REG_COMMON_GET_PARAM
+/** @brief Readable register returning one parameter; written with the u16 parameter ID to select it. */
+#define REG_COMMON_GET_PARAM 0x1B
+#endif
+
+#ifndef REG_COMMON_PARAM_DUMP
+/** @brief Readable register returning every parameter of the module. */
+#define REG_COMMON_PARAM_DUMP 0x1C
+#endif
+
+/** @brief Bytes per (id, value) entry on the wire. */
+#define I2C_PROTO_BATCH_ENTRY_LEN 6
+
+/** @brief Largest batch that fits in one transaction together with the register and count bytes. */
+#define I2C_PROTO_BATCH_MAX_PARAMS 10
+
+/**
+ * @brief Packs a batched SET payload.
+ * @param ids Parameter IDs.
+ * @param values Parameter values, one per ID.
+ * @param count Number of entries, at most I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param buf Destination for the payload (without the register byte).
+ * @param buf_len Size of buf.
+ * @return int Payload length in bytes, or -1 if it does not fit.
+ */
+int i2c_proto_pack_set_param_batch(const ParamId_t *ids, const ParamValue_t *values, uint8_t count, uint8_t *buf,
+                                   int buf_len);
+
+/**
+ * @brief Unpacks a batched SET payload.
+ * @param buf Payload (without the register byte).
+ * @param len Payload length.
+ * @param ids Filled with the parameter IDs; room for I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param values Filled with the parameter values; room for I2C_PROTO_BATCH_MAX_PARAMS.
+ * @param count Filled with the number of entries.
+ * @return bool True if the payload is well formed.
+ */
+bool i2c_proto_unpack_set_param_batch(const uint8_t *buf, int len, ParamId_t *ids, ParamValue_t *values,
+                                      uint8_t *count);
+
+#endif
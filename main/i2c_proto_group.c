@@ -0,0 +1,43 @@
+/**
+ * @file i2c_proto_group.c
+ * @brief Implementation of the group commands of the module I2C protocol.
+ */
+
+#include "i2c_proto_group.h"
+
+/**
+ * @brief Packs a REG_COMMON_GROUP_COMMIT payload.
+ * @param group The group to commit.
+ * @param frame Commit frame, counted from the last REG_COMMON_FRAME_SYNC.
+ * @param buf Destination for the payload (without the register byte).
+ * @param buf_len Size of buf.
+ * @return int Payload length in bytes, or -1 if it does not fit.
+ */
+int i2c_proto_pack_group_commit(uint8_t group, uint32_t frame, uint8_t *buf, int buf_len)
+{
+    if (buf_len < 5)
+        return -1;
+    buf[0] = group;
+    buf[1] = frame & 0xFF;
+    buf[2] = (frame >> 8) & 0xFF;
+    buf[3] = (frame >> 16) & 0xFF;
+    buf[4] = frame >> 24;
+    return 5;
+}
+
+/**
+ * @brief Unpacks a REG_COMMON_GROUP_COMMIT payload.
+ * @param buf Payload (without the register byte).
+ * @param len Payload length.
+ * @param group Filled with the group.
+ * @param frame Filled with the commit frame.
+ * @return bool True if the payload is well formed.
+ */
+bool i2c_proto_unpack_group_commit(const uint8_t *buf, int len, uint8_t *group, uint32_t *frame)
+{
+    if (len < 5)
+        return false;
+    *group = buf[0];
+    *frame = buf[1] | (buf[2] << 8) | (buf[3] << 16) | ((uint32_t)buf[4] << 24);
+    return true;
+}
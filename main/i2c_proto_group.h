@@ -0,0 +1,63 @@
+/**
+ * @file i2c_proto_group.h
+ * @brief Header file for the group commands of the module I2C protocol, sent by general call to update several modules on one frame.
+ *
+ * Payload layouts after the register byte, all fields little-endian:
+ *   REG_COMMON_GROUP_CONFIG  group mask (u8); bit n makes the module a member of group n + 1.
+ *   REG_COMMON_FRAME_SYNC    empty; the frame on which it completes becomes frame 0 for commits.
+ *   REG_COMMON_GROUP_ARM     group (u8), then a batched SET payload staged until the commit.
+ *   REG_COMMON_GROUP_COMMIT  group (u8), frame (u32) counted from the last REG_COMMON_FRAME_SYNC.
+ * Group 0 addresses every module.
+ */
+
+#ifndef I2C_PROTO_GROUP_H
+#define I2C_PROTO_GROUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "module_i2c_proto.h"
+
+#ifndef REG_COMMON_GROUP_CONFIG
+/** @brief Register setting the groups the module belongs to; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_GROUP_CONFIG 0x1D
+#endif
+
+#ifndef REG_COMMON_FRAME_SYNC
+/** @brief Register marking the common frame origin; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_FRAME_SYNC 0x1E
+#endif
+
+#ifndef REG_COMMON_GROUP_ARM
+/** @brief Register staging parameters for a group; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_GROUP_ARM 0x1F
+#endif
+
+#ifndef REG_COMMON_GROUP_COMMIT
+/** @brief Register applying a group's staged parameters on a frame; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_GROUP_COMMIT 0x20
+#endif
+
+/** @brief Group number addressing every module. */
+#define I2C_PROTO_GROUP_ALL 0
+
+/**
+ * @brief Packs a REG_COMMON_GROUP_COMMIT payload.
+ * @param group The group to commit.
+ * @param frame Commit frame, counted from the last REG_COMMON_FRAME_SYNC.
+ * @param buf Destination for the payload (without the register byte).
+ * @param buf_len Size of buf.
+ * @return int Payload length in bytes, or -1 if it does not fit.
+ */
+int i2c_proto_pack_group_commit(uint8_t group, uint32_t frame, uint8_t *buf, int buf_len);
+
+/**
+ * @brief Unpacks a REG_COMMON_GROUP_COMMIT payload.
+ * @param buf Payload (without the register byte).
+ * @param len Payload length.
+ * @param group Filled with the group.
+ * @param frame Filled with the commit frame.
+ * @return bool True if the payload is well formed.
+ */
+bool i2c_proto_unpack_group_commit(const uint8_t *buf, int len, uint8_t *group, uint32_t *frame);
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file i2c_proto_preset.h
+ * @brief Header file for the preset bank commands of the module I2C protocol.
+ *
+ * Payload layouts after the register byte:
+ *   REG_COMMON_PROGRAM_CHANGE  slot (u8); recalls the preset in that slot.
+ *   REG_COMMON_PRESET_STORE    slot (u8), then the name (up to 15 bytes, no terminator needed);
+ *                              stores the live parameters in that slot.
+ *   REG_COMMON_MORPH           slot A (u8), slot B (u8), source (u8): a TDM slot 0–15 or 0xFF for
+ *                              REG_COMMON_MORPH_POSITION; starts morphing between the two presets.
+ *                              An empty payload stops the morph and keeps the current sound.
+ *   REG_COMMON_MORPH_POSITION  position (u16, little-endian), 0 for preset A to 65535 for B.
+ */
+
+#ifndef I2C_PROTO_PRESET_H
+#define I2C_PROTO_PRESET_H
+
+#include "module_i2c_proto.h"
+
+#ifndef REG_COMMON_PROGRAM_CHANGE
+/** @brief Register recalling a preset; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_PROGRAM_CHANGE 0x21
+#endif
+
+#ifndef REG_COMMON_PRESET_STORE
+/** @brief Register storing the live parameters as a preset; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_PRESET_STORE 0x22
+#endif
+
+#ifndef REG_COMMON_MORPH
+/** @brief Register starting or stopping a preset morph; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_MORPH 0x23
+#endif
+
+#ifndef REG_COMMON_MORPH_POSITION
+/** @brief Register setting the morph position; only defined here until module_i2c_proto carries it. */
+#define REG_COMMON_MORPH_POSITION 0x24
+#endif
+
+#endif
@@ -4,234 +4,568 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/i2c.h"
-#include "driver/i2s.h"
+#include "freertos/queue.h"
+#include "driver/i2s_std.h"
+#include "driver/i2s_tdm.h"
+#include "esp_idf_version.h"
 #include "nvs_flash.h"
 #include "common.h"
 #include "module_i2c_proto.h"
 #include "waveform_gen.h"
+#include "tdm_ring.h"
+#include "param_registry.h"
+#include "param_store.h"
+#include "audio_clock.h"
+#include "settings_worker.h"
+#include "i2c_link.h"
+#include "i2c_proto_batch.h"
+#include "i2c_proto_group.h"
+#include "param_group.h"
+#include "i2c_proto_preset.h"
+#include "preset_bank.h"
+#include "preset_morph.h"
+#include "boot_profile.h"
+#include "warm_cache.h"
 #include "Esp_menu.h"
 #include "user_actions.h"
 
-/** @brief Enable debug mode with PCM5102A output (GPIO 4–6). */
-#define DEBUG_MODE 1
-
 /** @brief I2C slave address for the oscillator module. */
-#define I2C_SLAVE_ADDR 0x50
+#define I2C_SLAVE_ADDR CONFIG_OSC_I2C_SLAVE_ADDR
+
+/** @brief I2C slave SDA pin. */
+#define I2C_SDA_GPIO 8
 
-/** @brief I2C port number. */
-#define I2C_PORT I2C_NUM_0
+/** @brief I2C slave SCL pin. */
+#define I2C_SCL_GPIO 9
+
+/** @brief Firmware version reported in REG_COMMON_FIRMWARE_VERSION (major, minor). */
+#define OSC_FIRMWARE_VERSION_MAJOR 1
+#define OSC_FIRMWARE_VERSION_MINOR 1
 
 /** @brief I2S port number. */
 #define I2S_PORT I2S_NUM_0
 
+/** @brief Number of I2S DMA descriptors (buffers) in each of the TX and RX rings. */
+#define I2S_DMA_DESC_NUM CONFIG_OSC_I2S_DMA_DESC_NUM
+
+/** @brief Frames per I2S DMA buffer; also the audio render block size. */
+#define I2S_DMA_FRAME_NUM CONFIG_OSC_I2S_DMA_FRAME_NUM
+
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+/** @brief DMA periods between rendering a block and it starting to play: it is rendered into the buffer just sent, which goes out after every other one. */
+#define I2S_RENDER_AHEAD_PERIODS (I2S_DMA_DESC_NUM - 1)
+#else
+/** @brief DMA periods between rendering a block and it starting to play: the copy waits one period for a buffer to free, which then goes out after every other one. */
+#define I2S_RENDER_AHEAD_PERIODS I2S_DMA_DESC_NUM
+#endif
+
+#ifdef CONFIG_OSC_I2S_DEBUG_DAC
+/** @brief 16-bit samples per I2S frame in the DMA buffers (mono, duplicated by the driver). */
+#define I2S_SAMPLES_PER_FRAME 1
+#else
+/** @brief 16-bit samples per I2S frame in the DMA buffers (every TDM slot). */
+#define I2S_SAMPLES_PER_FRAME TDM_SLOT_COUNT
+#endif
+
 /** @brief Audio sample rate (Hz). */
 #define SAMPLE_RATE 44100
 
 /** @brief TCA9548A channel for I2C communication. */
 #define TCA9548A_CHANNEL 0
 
-/** @brief Array of parameter values for the oscillator module. */
-static ParamValue_t params[] = {
-    [PARAM_OSC_WAVEFORM - PARAM_RANGE_OSC] = {.u8[0] = OSC_WAVE_SINE},
-    [PARAM_OSC_FREQUENCY_PITCH -
-        PARAM_RANGE_OSC] = {.u8[0] = 69},
-    [PARAM_OSC_FREQUENCY_FINE -
-        PARAM_RANGE_OSC] = {.s16[0] = 0},
-    [PARAM_OSC_LEVEL -
-        PARAM_RANGE_OSC] = {.u16[0] = 65535},
-    [PARAM_OSC_AMP_MOD_SLOT -
-        PARAM_RANGE_OSC] = {.u8[0] = 0xFF},
-    [PARAM_OSC_FREQ_MOD_SLOT -
-        PARAM_RANGE_OSC] = {.u8[0] = 0xFF},
-    [PARAM_OSC_PW -
-        PARAM_RANGE_OSC] = {.u16[0] = 32768},
-    [PARAM_OSC_SYNC_SOURCE_SLOT -
-        PARAM_RANGE_OSC] = {.u8[0] = 0xFF}};
-
 /** @brief I2S configuration for the oscillator module. */
 static I2sConfig_t i2s_config = {0, 0x0001};
 
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-/** @brief Flag indicating if parameters have changed (for NVS saving). */
-bool param_changed = false;
+/** @brief TDM slots this module drives, taken from i2s_config and picked up by the audio task once per block. */
+static volatile uint16_t tdm_slot_mask = 0x0001;
+
+/** @brief I2S TX channel handle. */
+static i2s_chan_handle_t i2s_tx_handle = NULL;
 
-/** @brief Timestamp of the last parameter change. */
-TickType_t last_param_change = 0;
+#ifndef CONFIG_OSC_I2S_DEBUG_DAC
+/** @brief I2S RX channel handle, capturing the backplane TDM frames used as modulation inputs. */
+static i2s_chan_handle_t i2s_rx_handle = NULL;
+#endif
+
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+/** @brief DMA buffers that have just been sent and are free to render into, posted by the on_sent ISR. */
+static QueueHandle_t i2s_free_buf_queue = NULL;
 #endif
 
+/**
+ * @brief Rebuilds the REG_COMMON_STATUS response from the current slot assignment.
+ */
+static void update_status_response(void)
+{
+    uint8_t status[3] = {0x01, i2s_config.slot_mask & 0xFF, i2s_config.slot_mask >> 8};
+    i2c_link_set_response(REG_COMMON_STATUS, status, sizeof(status));
+}
+
 /**
  * @brief Initializes the I2C slave interface for communication with the central controller.
  */
 void init_i2c_slave()
 {
-    i2c_config_t conf = {
-        .mode = I2C_MODE_SLAVE,
-        .sda_io_num = 8,
-        .scl_io_num = 9,
-        .sda_pullup_en = GPIO_PULLUP_ENABLE,
-        .scl_pullup_en = GPIO_PULLUP_ENABLE,
-        .slave.addr_10bit_en = 0,
-        .slave.slave_addr = I2C_SLAVE_ADDR,
-    };
-    ESP_ERROR_CHECK(i2c_param_config(I2C_PORT, &conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_PORT, conf.mode, 1024, 1024, 0));
+    i2c_link_init(I2C_SDA_GPIO, I2C_SCL_GPIO, I2C_SLAVE_ADDR);
+    const uint8_t module_type = MODULE_TYPE_OSCILLATOR;
+    i2c_link_set_response(REG_COMMON_MODULE_TYPE, &module_type, 1);
+    const uint8_t version[2] = {OSC_FIRMWARE_VERSION_MAJOR, OSC_FIRMWARE_VERSION_MINOR};
+    i2c_link_set_response(REG_COMMON_FIRMWARE_VERSION, version, sizeof(version));
+    update_status_response();
+}
+
+/**
+ * @brief I2S TX-done callback, advancing the audio clock and posting the DMA buffer that just finished sending to the audio task.
+ * @param handle The I2S channel handle.
+ * @param event Event data holding the sent DMA buffer.
+ * @param user_ctx Unused user context.
+ * @return bool True if a higher-priority task was woken.
+ */
+static IRAM_ATTR bool i2s_on_sent(i2s_chan_handle_t handle, i2s_event_data_t *event, void *user_ctx)
+{
+    audio_clock_advance_from_isr(I2S_DMA_FRAME_NUM);
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+    void *dma_buf = event->dma_buf;
+#else
+    void *dma_buf = *(void **)event->data;
+#endif
+    BaseType_t woken = pdFALSE;
+    xQueueSendFromISR(i2s_free_buf_queue, &dma_buf, &woken);
+    return woken == pdTRUE;
+#else
+    return false;
+#endif
 }
 
 /**
  * @brief Initializes the I2S interface for audio output.
+ *
+ * In debug mode the module is I2S master into a PCM5102A. Otherwise it is a TDM slave on the
+ * backplane BCLK/WS with every slot enabled, so slot reassignment only changes which slots
+ * the audio task fills and never needs the channel to be stopped or reconfigured. The backplane
+ * is also captured full-duplex on the same port so other modules' slots can drive modulation.
+ *
+ * The ESP32-S3 I2S transmitter drives SD_OUT for the whole frame and cannot release the pin in
+ * slots it does not own: disabling a TX slot only drops it from the DMA buffer, and the pin
+ * still outputs a level during it. SD_OUT must therefore be this module's own line into the
+ * Central Controller (or its mixer), never a data line shared with other modules.
  */
 void init_i2s()
 {
-    i2s_config_t i2s_conf = {
-        .mode = I2S_MODE_MASTER | I2S_MODE_TX,
-        .sample_rate = SAMPLE_RATE,
-        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-        .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
-        .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-        .intr_alloc_flags = 0,
-        .dma_buf_count = 8,
-        .dma_buf_len = 64,
+#ifdef CONFIG_OSC_I2S_DEBUG_DAC
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_PORT, I2S_ROLE_MASTER);
+#else
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_PORT, I2S_ROLE_SLAVE);
+#endif
+    chan_cfg.dma_desc_num = I2S_DMA_DESC_NUM;
+    chan_cfg.dma_frame_num = I2S_DMA_FRAME_NUM;
+
+#ifdef CONFIG_OSC_I2S_DEBUG_DAC
+    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &i2s_tx_handle, NULL));
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = 4,
+            .ws = 5,
+            .dout = 6,
+            .din = I2S_GPIO_UNUSED,
+        },
+    };
+    // One rendered sample per frame, duplicated on both channels of the debug DAC
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_BOTH;
+    ESP_ERROR_CHECK(i2s_channel_init_std_mode(i2s_tx_handle, &std_cfg));
+#else
+    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &i2s_tx_handle, &i2s_rx_handle));
+    i2s_tdm_config_t tdm_cfg = {
+        .clk_cfg = I2S_TDM_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+        .slot_cfg = I2S_TDM_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_STEREO,
+                                                        (i2s_tdm_slot_mask_t)((1u << TDM_SLOT_COUNT) - 1)),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = CONFIG_OSC_TDM_BCLK_GPIO,
+            .ws = CONFIG_OSC_TDM_WS_GPIO,
+            .dout = CONFIG_OSC_TDM_DOUT_GPIO,
+            .din = CONFIG_OSC_TDM_DIN_GPIO,
+        },
+    };
+    ESP_ERROR_CHECK(i2s_channel_init_tdm_mode(i2s_tx_handle, &tdm_cfg));
+    ESP_ERROR_CHECK(i2s_channel_init_tdm_mode(i2s_rx_handle, &tdm_cfg));
+#endif
+
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+    i2s_free_buf_queue = xQueueCreate(I2S_DMA_DESC_NUM, sizeof(void *));
+#endif
+    audio_clock_init(SAMPLE_RATE);
+    i2s_event_callbacks_t cbs = {
+        .on_sent = i2s_on_sent,
     };
-    ESP_ERROR_CHECK(i2s_driver_install(I2S_PORT, &i2s_conf, 0, NULL));
-    ESP_ERROR_CHECK(i2s_set_pin(I2S_PORT, &(i2s_pin_config_t){
-                                              .bck_io_num = 4,
-                                              .ws_io_num = 5,
-                                              .data_out_num = 6,
-                                              .data_in_num = I2S_PIN_NO_CHANGE}));
+    ESP_ERROR_CHECK(i2s_channel_register_event_callback(i2s_tx_handle, &cbs, NULL));
+    ESP_ERROR_CHECK(i2s_channel_enable(i2s_tx_handle));
+#ifndef CONFIG_OSC_I2S_DEBUG_DAC
+    ESP_ERROR_CHECK(i2s_channel_enable(i2s_rx_handle));
+#endif
+}
+
+#ifndef CONFIG_OSC_I2S_DEBUG_DAC
+/**
+ * @brief Spreads a rendered block over the TDM slots assigned to this module.
+ * @param frames Destination DMA buffer, TDM_SLOT_COUNT samples per frame.
+ * @param block Rendered mono samples, one per frame.
+ * @param mask Slots to drive; every other slot is written as silence.
+ *
+ * The silent slots are still driven, which is why SD_OUT has to be a per-module line (see
+ * init_i2s()); on that line they read as zeros rather than as another module's audio.
+ */
+static void tdm_fill_frames(int16_t *frames, const int16_t *block, uint16_t mask)
+{
+    for (int f = 0; f < I2S_DMA_FRAME_NUM; f++)
+    {
+        int16_t sample = block[f];
+        for (int slot = 0; slot < TDM_SLOT_COUNT; slot++)
+            frames[slot] = (mask >> slot) & 1 ? sample : 0;
+        frames += TDM_SLOT_COUNT;
+    }
+}
+
+/**
+ * @brief Task to capture backplane TDM frames and hand them to the audio task as modulation inputs.
+ * @param arg Unused task argument.
+ *
+ * Each DMA buffer is de-interleaved by slot into the next free block of the TDM ring. If the
+ * audio task has fallen behind and the ring is full, the capture is dropped rather than blocking
+ * the receive DMA.
+ */
+void tdm_rx_task(void *arg)
+{
+    static int16_t frames[TDM_RING_FRAMES * TDM_SLOT_COUNT];
+    while (1)
+    {
+        size_t bytes_read;
+        if (i2s_channel_read(i2s_rx_handle, frames, sizeof(frames), &bytes_read, portMAX_DELAY) != ESP_OK ||
+            bytes_read != sizeof(frames))
+            continue;
+        tdm_block_t *block = tdm_ring_acquire();
+        if (!block)
+            continue;
+        const int16_t *src = frames;
+        for (int f = 0; f < TDM_RING_FRAMES; f++)
+        {
+            for (int slot = 0; slot < TDM_SLOT_COUNT; slot++)
+                block->slots[slot][f] = src[slot];
+            src += TDM_SLOT_COUNT;
+        }
+        tdm_ring_publish();
+    }
+}
+#endif
+
+/**
+ * @brief Reports whether a command may be acted on when it arrives by general call.
+ * @param reg The command register.
+ * @return bool True for the group synchronisation commands, which are meant for every module.
+ *
+ * Everything else, including the standard general call commands (0x06 reset, 0x04 latch
+ * address) that would otherwise read as register IDs, is addressed to one module only.
+ */
+static bool general_call_allowed(uint8_t reg)
+{
+    return reg == REG_COMMON_FRAME_SYNC || reg == REG_COMMON_GROUP_ARM || reg == REG_COMMON_GROUP_COMMIT;
 }
 
 /**
  * @brief Task to handle I2C slave communication, processing commands from the central controller.
+ *
+ * Blocks on the I2C link queue, so it only wakes for a completed write or to send the rest of a
+ * long response.
+ * General calls are dropped unless general_call_allowed() accepts them.
  * @param arg Unused task argument.
  */
 void i2c_slave_task(void *arg)
 {
-    uint8_t data[8];
+    i2c_link_msg_t msg;
     while (1)
     {
-        int len = i2c_slave_read_buffer(I2C_PORT, data, sizeof(data), pdMS_TO_TICKS(I2C_TIMEOUT_MS));
-        if (len > 0)
+        if (!i2c_link_receive(&msg, portMAX_DELAY))
+            continue;
+        const uint8_t *data = msg.data;
+        int len = msg.len;
+        ESP_LOGD("I2C_SLAVE", "Received %d bytes: cmd=0x%02X%s", len, data[0], msg.general_call ? " (general call)" : "");
+        if (msg.general_call && !general_call_allowed(data[0]))
+            continue;
+        if (data[0] == REG_COMMON_SET_PARAM && len >= 7)
         {
-            ESP_LOGD("I2C_SLAVE", "Received %d bytes: cmd=0x%02X", len, data[0]);
-            if (data[0] == REG_COMMON_SET_PARAM && len >= 7)
+            ParamId_t param_id;
+            ParamValue_t param_value;
+            if (i2c_proto_unpack_set_param_payload(data + 1, len - 1, &param_id, &param_value))
             {
-                ParamId_t param_id;
-                ParamValue_t param_value;
-                if (i2c_proto_unpack_set_param_payload(data + 1, len - 1, &param_id, &param_value))
+                int field = param_registry_find(param_id);
+                if (field >= 0)
                 {
-                    if (param_id >= PARAM_RANGE_OSC && param_id < PARAM_RANGE_OSC + sizeof(params) / sizeof(params[0]))
-                    {
-                        params[param_id - PARAM_RANGE_OSC] = param_value;
-                        switch (param_id)
-                        {
-                        case PARAM_OSC_FREQUENCY_PITCH:
-                            menu_params.frequency_pitch = param_value.u8[0];
-                            break;
-                        case PARAM_OSC_FREQUENCY_FINE:
-                            menu_params.frequency_fine = param_value.s16[0];
-                            break;
-                        case PARAM_OSC_WAVEFORM:
-                            menu_params.waveform = param_value.u8[0];
-                            break;
-                        case PARAM_OSC_LEVEL:
-                            menu_params.level = param_value.u16[0];
-                            break;
-                        case PARAM_OSC_PW:
-                            menu_params.pulse_width = param_value.u16[0];
-                            break;
-                        case PARAM_OSC_AMP_MOD_SLOT:
-                            menu_params.amp_mod_slot = param_value.u8[0];
-                            break;
-                        case PARAM_OSC_FREQ_MOD_SLOT:
-                            menu_params.freq_mod_slot = param_value.u8[0];
-                            break;
-                        case PARAM_OSC_SYNC_SOURCE_SLOT:
-                            menu_params.sync_source_slot = param_value.u8[0];
-                            break;
-                        }
-                        save_to_nvs();
-                        user_update_display();
-                    }
+                    param_set(param_store_write_begin(), field, param_from_wire(field, param_value));
+                    param_store_write_end();
+                    settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
                 }
             }
-            else if (data[0] == REG_COMMON_I2S_CONFIG && len >= 5)
+        }
+        else if (data[0] == REG_COMMON_SET_PARAM_BATCH && len >= 2)
+        {
+            ParamId_t ids[I2C_PROTO_BATCH_MAX_PARAMS];
+            ParamValue_t values[I2C_PROTO_BATCH_MAX_PARAMS];
+            uint8_t count;
+            if (i2c_proto_unpack_set_param_batch(data + 1, len - 1, ids, values, &count))
             {
-                i2c_proto_unpack_i2s_config_packet(data + 1, len - 1, &i2s_config);
+                // One write section, so the whole batch is published and applied on the same frame
+                MenuParams_t *params = param_store_write_begin();
+                for (uint8_t i = 0; i < count; i++)
+                {
+                    int field = param_registry_find(ids[i]);
+                    if (field >= 0)
+                        param_set(params, field, param_from_wire(field, values[i]));
+                }
+                param_store_write_end();
+                settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
             }
-            else if (data[0] == CMD_COMMON_RESET)
+        }
+        else if (data[0] == REG_COMMON_GROUP_CONFIG && len >= 2)
+        {
+            param_group_set_mask(data[1]);
+        }
+        else if (data[0] == REG_COMMON_FRAME_SYNC)
+        {
+            param_group_sync(audio_clock_frame_at(msg.time_us));
+        }
+        else if (data[0] == REG_COMMON_GROUP_ARM && len >= 3)
+        {
+            ParamId_t ids[I2C_PROTO_BATCH_MAX_PARAMS];
+            ParamValue_t values[I2C_PROTO_BATCH_MAX_PARAMS];
+            uint8_t count;
+            if (param_group_member(data[1]) &&
+                i2c_proto_unpack_set_param_batch(data + 2, len - 2, ids, values, &count))
+                param_group_arm(ids, values, count);
+        }
+        else if (data[0] == REG_COMMON_GROUP_COMMIT && len >= 6)
+        {
+            uint8_t group;
+            uint32_t frame;
+            // Published, saved and redrawn by the settings worker once the audio task has applied it
+            if (i2c_proto_unpack_group_commit(data + 1, len - 1, &group, &frame) && param_group_member(group))
+                param_group_commit(frame);
+        }
+        else if (data[0] == REG_COMMON_PROGRAM_CHANGE && len >= 2)
+        {
+            // A recently used preset comes from the RAM cache; others cost one small NVS read
+            if (preset_bank_recall(data[1]))
+                settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
+        }
+        else if (data[0] == REG_COMMON_PRESET_STORE && len >= 2)
+        {
+            char name[PRESET_NAME_LEN] = {0};
+            memcpy(name, data + 2, len - 2 < PRESET_NAME_LEN - 1 ? len - 2 : PRESET_NAME_LEN - 1);
+            settings_worker_store_preset(data[1], name);
+        }
+        else if (data[0] == REG_COMMON_MORPH)
+        {
+            bool changed;
+            if (len >= 4)
             {
-                menu_params = (MenuParams_t){69, 0, OSC_WAVE_SINE, 65535, 32768, 0xFF, 0xFF, 0xFF};
-                params[PARAM_OSC_WAVEFORM - PARAM_RANGE_OSC] = (ParamValue_t){.u8[0] = OSC_WAVE_SINE};
-                params[PARAM_OSC_FREQUENCY_PITCH - PARAM_RANGE_OSC] = (ParamValue_t){.u8[0] = 69};
-                params[PARAM_OSC_FREQUENCY_FINE - PARAM_RANGE_OSC] = (ParamValue_t){.s16[0] = 0};
-                params[PARAM_OSC_LEVEL - PARAM_RANGE_OSC] = (ParamValue_t){.u16[0] = 65535};
-                params[PARAM_OSC_PW - PARAM_RANGE_OSC] = (ParamValue_t){.u16[0] = 32768};
-                params[PARAM_OSC_AMP_MOD_SLOT - PARAM_RANGE_OSC] = (ParamValue_t){.u8[0] = 0xFF};
-                params[PARAM_OSC_FREQ_MOD_SLOT - PARAM_RANGE_OSC] = (ParamValue_t){.u8[0] = 0xFF};
-                params[PARAM_OSC_SYNC_SOURCE_SLOT - PARAM_RANGE_OSC] = (ParamValue_t){.u8[0] = 0xFF};
-                save_to_nvs();
-                user_update_display();
+                changed = preset_morph_start(data[1], data[2], data[3]);
+                if (!changed)
+                    ESP_LOGW("I2C_SLAVE", "Morph between presets %u and %u rejected: empty or invalid slot", data[1],
+                             data[2]);
             }
-            else if (data[0] == CMD_COMMON_SAVE_SETTINGS)
+            else
+                changed = preset_morph_stop();
+            if (changed)
+                settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
+        }
+        else if (data[0] == REG_COMMON_MORPH_POSITION && len >= 3)
+        {
+            preset_morph_set_position(data[1] | (data[2] << 8));
+        }
+        else if (data[0] == REG_COMMON_I2S_CONFIG && len >= 5)
+        {
+            if (i2c_proto_unpack_i2s_config_packet(data + 1, len - 1, &i2s_config))
             {
-                save_to_nvs();
+                // Applied by the audio task at the start of the next DMA buffer, i.e. on a frame boundary
+                tdm_slot_mask = i2s_config.slot_mask;
+                update_status_response();
             }
         }
+        else if (data[0] == CMD_COMMON_RESET)
+        {
+            param_set_defaults(param_store_write_begin());
+            param_store_write_end();
+            settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
+        }
+        else if (data[0] == CMD_COMMON_SAVE_SETTINGS)
+        {
+            settings_worker_post(SETTINGS_WORK_SAVE_NOW);
+        }
     }
 }
 
 /**
- * @brief Task to generate and output audio waveforms via I2S.
- * @param arg Unused task argument.
+ * @brief Renders one DMA block, applying every queued parameter event on its exact frame.
+ * @param osc The oscillator to render.
+ * @param params The parameters currently applied; updated by the events.
+ * @param out Destination for I2S_DMA_FRAME_NUM samples.
+ * @param block_frame audio_clock frame on which the block starts playing.
+ * @param mod Captured TDM block feeding the modulation inputs, or NULL.
+ *
+ * The block is rendered in runs split at each due event's and committed parameter group's
+ * offset; on the same frame a group is applied after the events. Events and groups whose frame
+ * has already passed are applied at the start of the block. While a preset morph runs, the
+ * oscillator follows the morphed parameters, computed once per block, and the events only
+ * keep params current for when it stops.
  */
-void audio_task(void *arg)
+static void audio_render_block(osc_t *osc, MenuParams_t *params, int16_t *out, uint32_t block_frame,
+                               const tdm_block_t *mod)
 {
-    int16_t buffer[64];
-    waveform_init(SAMPLE_RATE);
-    while (1)
+    MenuParams_t morphed;
+    const MenuParams_t *osc_params = preset_morph_block(mod, &morphed) ? &morphed : params;
+    uint32_t pos = 0;
+    while (pos < I2S_DMA_FRAME_NUM)
     {
-        waveform_set_params(
-            menu_params.frequency_pitch,
-            menu_params.frequency_fine,
-            menu_params.waveform,
-            menu_params.level,
-            menu_params.pulse_width,
-            menu_params.amp_mod_slot,
-            menu_params.freq_mod_slot,
-            menu_params.sync_source_slot);
-        waveform_generate(buffer, 64);
-        size_t bytes_written;
-        i2s_write(I2S_PORT, buffer, 64 * sizeof(int16_t), &bytes_written, portMAX_DELAY);
+        uint32_t end = I2S_DMA_FRAME_NUM;
+        param_event_t ev;
+        while (param_store_peek_event(&ev))
+        {
+            int32_t offset = (int32_t)(ev.frame - block_frame);
+            if (offset > (int32_t)pos)
+            {
+                if (offset < I2S_DMA_FRAME_NUM)
+                    end = offset;
+                break;
+            }
+            param_store_apply_event(params, &ev);
+            param_store_pop_event();
+        }
+        uint32_t group_frame;
+        while (param_group_peek(&group_frame))
+        {
+            int32_t offset = (int32_t)(group_frame - block_frame);
+            if (offset > (int32_t)pos)
+            {
+                if (offset < (int32_t)end)
+                    end = offset;
+                break;
+            }
+            param_group_apply(params);
+        }
+        osc_set_params(
+            osc,
+            osc_params->frequency_pitch,
+            osc_params->frequency_fine,
+            osc_params->waveform,
+            osc_params->level,
+            osc_params->pulse_width,
+            osc_params->amp_mod_slot,
+            osc_params->freq_mod_slot,
+            osc_params->sync_source_slot);
+        // Shifting the base keeps every slot's run aligned with this part of the block
+        waveform_set_mod_input(mod ? mod->slots[0] + pos : NULL, TDM_RING_FRAMES);
+        osc_render(osc, out + pos, end - pos);
+        pos = end;
     }
 }
 
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
 /**
- * @brief Task to periodically save changed parameters to NVS.
+ * @brief Task to generate and output audio waveforms via I2S.
  * @param arg Unused task argument.
+ *
+ * With CONFIG_OSC_I2S_ZERO_COPY each block is written straight into the DMA buffer the
+ * on_sent callback has just reported free, so the driver makes no copy and every block is
+ * produced exactly one DMA period after the previous one. Otherwise blocks are staged in a
+ * static buffer and copied in by i2s_channel_write(). On the TDM backplane the rendered block
+ * is spread over the assigned slots as it is written, and the newest captured TDM block is
+ * handed to the oscillator as its per-sample modulation input.
+ *
+ * The block being rendered goes out after every other DMA buffer (plus the period the copy
+ * waits for a free one), which fixes its start frame on the audio clock; parameter events are applied within it at their exact frame. If the
+ * event queue overflowed, the parameters are reloaded from the published snapshot instead.
  */
-void nvs_task(void *arg)
+void audio_task(void *arg)
 {
+    osc_t osc;
+    MenuParams_t params;
+    bool resync = false;
+    param_store_get(&params);
+    waveform_init(SAMPLE_RATE);
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+    osc_benchmark_kernels();
+#endif
+    osc_init(&osc);
+    // Pitch and fine tune share one glide; use the longer of their smoothing times
+    uint16_t pitch_ms = param_registry[PARAM_FIELD_PITCH].smooth_ms;
+    if (param_registry[PARAM_FIELD_FINE].smooth_ms > pitch_ms)
+        pitch_ms = param_registry[PARAM_FIELD_FINE].smooth_ms;
+    osc_set_smoothing(&osc, pitch_ms, param_registry[PARAM_FIELD_LEVEL].smooth_ms, param_registry[PARAM_FIELD_PW].smooth_ms);
+#ifndef CONFIG_OSC_I2S_ZERO_COPY
+    static int16_t dma_block[I2S_DMA_FRAME_NUM * I2S_SAMPLES_PER_FRAME];
+#endif
+#ifndef CONFIG_OSC_I2S_DEBUG_DAC
+    int16_t block[I2S_DMA_FRAME_NUM];
+#endif
+    bool first_block = true;
     while (1)
     {
-        if (param_changed && (xTaskGetTickCount() - last_param_change > pdMS_TO_TICKS(1000)))
+#ifdef CONFIG_OSC_I2S_ZERO_COPY
+        int16_t *dma_block;
+        xQueueReceive(i2s_free_buf_queue, &dma_block, portMAX_DELAY);
+#endif
+        uint32_t block_frame = audio_clock_frames() + I2S_RENDER_AHEAD_PERIODS * I2S_DMA_FRAME_NUM;
+        if (param_store_take_resync() || resync)
         {
-            save_to_nvs();
-            param_changed = false;
+            // Retried next block if a writer is mid-publish; never blocks
+            resync = !param_store_resync(&params);
+        }
+#ifdef CONFIG_OSC_I2S_DEBUG_DAC
+        audio_render_block(&osc, &params, dma_block, block_frame, NULL);
+#else
+        audio_render_block(&osc, &params, block, block_frame, tdm_ring_latest());
+        tdm_fill_frames(dma_block, block, tdm_slot_mask);
+#endif
+#ifndef CONFIG_OSC_I2S_ZERO_COPY
+        size_t bytes_written;
+        i2s_channel_write(i2s_tx_handle, dma_block, sizeof(dma_block), &bytes_written, portMAX_DELAY);
+#endif
+        warm_cache_seal();
+        if (first_block)
+        {
+            boot_profile_mark(BOOT_STAGE_FIRST_SAMPLE);
+            first_block = false;
         }
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
-#endif
 
 /**
- * @brief Main application entry point, initializing NVS, I2C, I2S, and menu system.
+ * @brief Main application entry point, bringing the module up in stages so audio starts first.
+ *
+ * The oscillator starts on the compiled-in defaults before flash is touched. The saved
+ * parameters are then loaded and reach the audio task as ordinary parameter events, so the
+ * change is applied on a frame and smoothed like any other. The I2C slave comes up after
+ * that, so the controller never has its values replaced by the load. The display and
+ * encoder come last; app_main runs at priority 1, below every other task. The time of each
+ * stage is logged once the boot is complete.
  */
 void app_main(void)
 {
+    boot_profile_mark(BOOT_STAGE_APP_MAIN);
+    param_store_init();
+    preset_morph_init();
+    init_i2s();
+    xTaskCreate(audio_task, "audio_task", 4096, NULL, 5, NULL);
+#ifndef CONFIG_OSC_I2S_DEBUG_DAC
+    xTaskCreate(tdm_rx_task, "tdm_rx_task", 2048, NULL, 6, NULL);
+#endif
+    boot_profile_mark(BOOT_STAGE_AUDIO_STARTED);
+
 #ifdef CONFIG_ESPMENU_ENABLE_NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
@@ -240,20 +574,23 @@ void app_main(void)
         ESP_ERROR_CHECK(nvs_flash_init());
     }
 #endif
+    settings_worker_start();
+    user_init();
+    boot_profile_mark(BOOT_STAGE_STATE_LOADED);
 
     init_i2c_slave();
-    init_i2s();
-    user_init();
-    xTaskCreate(i2c_slave_task, "i2c_slave_task", 4096, NULL, 5, NULL);
-    xTaskCreate(audio_task, "audio_task", 4096, NULL, 5, NULL);
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    xTaskCreate(nvs_task, "nvs_task", 2048, NULL, 4, NULL);
-#endif
+    // Above the audio task so the rest of a long response reaches the driver before the TX FIFO drains
+    xTaskCreate(i2c_slave_task, "i2c_slave_task", 4096, NULL, 7, NULL);
+    boot_profile_mark(BOOT_STAGE_I2C_READY);
 
     esp_err_t err = esp_menu_init();
     if (err != ESP_OK)
     {
         printf("Failed to initialize menu system: %s\n", esp_err_to_name(err));
+        boot_profile_log();
         return;
     }
-}
\ No newline at end of file
+    settings_worker_enable_display();
+    boot_profile_mark(BOOT_STAGE_UI_READY);
+    boot_profile_log();
+}
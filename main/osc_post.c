@@ -0,0 +1,243 @@
+/**
+ * @file osc_post.c
+ * @brief Implementation of the block post-processing stage of the oscillator module.
+ *
+ * With CONFIG_OSC_POST_ESP_DSP the float stages use the esp-dsp kernels. These are not SIMD:
+ * the ESP32-S3 PIE vector unit has no float lanes, and esp-dsp's f32 multiply and add on
+ * Xtensa targets are hand-scheduled FPU loops, one sample per iteration, on the zero-overhead
+ * loop instruction. Whether they beat the compiled scalar loops is measured on the target by
+ * osc_post_benchmark(). Both paths perform the same single IEEE multiply or add per sample in
+ * the same order, so they produce bit-identical output and can be checked on a host build.
+ */
+
+#include "osc_post.h"
+#include "sdkconfig.h"
+#ifdef CONFIG_OSC_POST_ESP_DSP
+#include "dsps_mulc.h"
+#include "dsps_mul.h"
+#include "dsps_add.h"
+#endif
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+/** @brief Log tag. */
+#define TAG "osc_post"
+
+/** @brief Blocks timed per stage. */
+#define OSC_POST_BENCH_BLOCKS 256
+
+/** @brief Samples per timed block, as rendered by the oscillator. */
+#define OSC_POST_BENCH_BLOCK 64
+
+#ifdef CONFIG_OSC_POST_ESP_DSP
+/** @brief Name of the path the public functions take, for the benchmark log. */
+#define OSC_POST_BENCH_PATH "esp-dsp"
+#else
+/** @brief Name of the path the public functions take, for the benchmark log. */
+#define OSC_POST_BENCH_PATH "scalar"
+#endif
+#endif
+
+/**
+ * @brief Portable constant gain, used when esp-dsp is disabled and as the benchmark reference.
+ * @param in Input samples.
+ * @param out Output samples (may alias in).
+ * @param num_samples Number of samples.
+ * @param gain Gain to apply.
+ */
+static inline void osc_post_scale_scalar(const float *in, float *out, uint32_t num_samples, float gain)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+        out[i] = in[i] * gain;
+}
+
+/**
+ * @brief Portable element-wise multiply, used when esp-dsp is disabled and as the benchmark reference.
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+static inline void osc_post_mul_scalar(const float *a, const float *b, float *out, uint32_t num_samples)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+        out[i] = a[i] * b[i];
+}
+
+/**
+ * @brief Portable element-wise add, used when esp-dsp is disabled and as the benchmark reference.
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+static inline void osc_post_mix_scalar(const float *a, const float *b, float *out, uint32_t num_samples)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+        out[i] = a[i] + b[i];
+}
+
+/**
+ * @brief Multiplies a block by a constant gain.
+ * @param in Input samples.
+ * @param out Output samples (may alias in).
+ * @param num_samples Number of samples.
+ * @param gain Gain to apply.
+ */
+void osc_post_scale_f32(const float *in, float *out, uint32_t num_samples, float gain)
+{
+#ifdef CONFIG_OSC_POST_ESP_DSP
+    dsps_mulc_f32(in, out, (int)num_samples, gain, 1, 1);
+#else
+    osc_post_scale_scalar(in, out, num_samples, gain);
+#endif
+}
+
+/**
+ * @brief Multiplies a block by a linearly ramping gain.
+ * @param in Input samples.
+ * @param out Output samples (may alias in).
+ * @param num_samples Number of samples.
+ * @param gain Gain applied to the first sample.
+ * @param step Gain increment per sample.
+ * @return float Gain for the sample following the block.
+ *
+ * esp-dsp has no ramp kernel, so this stays scalar in both builds; it only runs while a
+ * level change is being smoothed.
+ */
+float osc_post_ramp_f32(const float *in, float *out, uint32_t num_samples, float gain, float step)
+{
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        out[i] = in[i] * gain;
+        gain += step;
+    }
+    return gain;
+}
+
+/**
+ * @brief Multiplies two blocks sample by sample (amplitude modulation).
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+void osc_post_mul_f32(const float *a, const float *b, float *out, uint32_t num_samples)
+{
+#ifdef CONFIG_OSC_POST_ESP_DSP
+    dsps_mul_f32(a, b, out, (int)num_samples, 1, 1, 1);
+#else
+    osc_post_mul_scalar(a, b, out, num_samples);
+#endif
+}
+
+/**
+ * @brief Adds two blocks sample by sample (mixing).
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+void osc_post_mix_f32(const float *a, const float *b, float *out, uint32_t num_samples)
+{
+#ifdef CONFIG_OSC_POST_ESP_DSP
+    dsps_add_f32(a, b, out, (int)num_samples, 1, 1, 1);
+#else
+    osc_post_mix_scalar(a, b, out, num_samples);
+#endif
+}
+
+/**
+ * @brief Converts a block to 16 bits, saturating instead of wrapping and truncating toward zero.
+ * @param in Input samples in 16-bit full scale.
+ * @param out Output samples.
+ * @param num_samples Number of samples.
+ *
+ * esp-dsp has no saturating float-to-int16 kernel, so this stage is always the branch-free
+ * clamp below, unrolled by four so the compiler can keep the FPU pipeline full.
+ */
+void osc_post_to_s16(const float *in, int16_t *out, uint32_t num_samples)
+{
+    uint32_t i = 0;
+    for (; i + 4 <= num_samples; i += 4)
+    {
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            float v = in[i + j];
+            v = v > 32767.0f ? 32767.0f : v;
+            v = v < -32768.0f ? -32768.0f : v;
+            out[i + j] = (int16_t)v;
+        }
+    }
+    for (; i < num_samples; i++)
+    {
+        float v = in[i];
+        v = v > 32767.0f ? 32767.0f : v;
+        v = v < -32768.0f ? -32768.0f : v;
+        out[i] = (int16_t)v;
+    }
+}
+
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+/**
+ * @brief Logs the cycles per sample of one post stage.
+ * @param name Stage name.
+ * @param path "esp-dsp" or "scalar".
+ * @param cycles Cycles taken by OSC_POST_BENCH_BLOCKS blocks.
+ */
+static void osc_post_bench_log(const char *name, const char *path, uint32_t cycles)
+{
+    ESP_LOGI(TAG, "post %-5s %-7s %6.2f cycles/sample", name, path,
+             (double)cycles / (OSC_POST_BENCH_BLOCKS * OSC_POST_BENCH_BLOCK));
+}
+
+/**
+ * @brief Measures and logs the cycles per sample of each post stage, for the build's path and for the scalar loops.
+ *
+ * With CONFIG_OSC_POST_ESP_DSP both are timed on the same buffers, so the log shows directly
+ * whether the esp-dsp kernels pay off on this target.
+ */
+void osc_post_benchmark(void)
+{
+    static float a[OSC_POST_BENCH_BLOCK] __attribute__((aligned(16)));
+    static float b[OSC_POST_BENCH_BLOCK] __attribute__((aligned(16)));
+    static float out[OSC_POST_BENCH_BLOCK] __attribute__((aligned(16)));
+    static int16_t pcm[OSC_POST_BENCH_BLOCK];
+    for (int i = 0; i < OSC_POST_BENCH_BLOCK; i++)
+    {
+        a[i] = (float)(i * 509 % 65536 - 32768);
+        b[i] = (float)i / OSC_POST_BENCH_BLOCK;
+    }
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_scale_f32(a, a, OSC_POST_BENCH_BLOCK, 1.0f);
+    osc_post_bench_log("gain", OSC_POST_BENCH_PATH, esp_cpu_get_cycle_count() - start);
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_mul_f32(a, b, out, OSC_POST_BENCH_BLOCK);
+    osc_post_bench_log("AM", OSC_POST_BENCH_PATH, esp_cpu_get_cycle_count() - start);
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_mix_f32(a, b, out, OSC_POST_BENCH_BLOCK);
+    osc_post_bench_log("mix", OSC_POST_BENCH_PATH, esp_cpu_get_cycle_count() - start);
+#ifdef CONFIG_OSC_POST_ESP_DSP
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_scale_scalar(a, a, OSC_POST_BENCH_BLOCK, 1.0f);
+    osc_post_bench_log("gain", "scalar", esp_cpu_get_cycle_count() - start);
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_mul_scalar(a, b, out, OSC_POST_BENCH_BLOCK);
+    osc_post_bench_log("AM", "scalar", esp_cpu_get_cycle_count() - start);
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_mix_scalar(a, b, out, OSC_POST_BENCH_BLOCK);
+    osc_post_bench_log("mix", "scalar", esp_cpu_get_cycle_count() - start);
+#endif
+    start = esp_cpu_get_cycle_count();
+    for (int n = 0; n < OSC_POST_BENCH_BLOCKS; n++)
+        osc_post_to_s16(a, pcm, OSC_POST_BENCH_BLOCK);
+    osc_post_bench_log("s16", "scalar", esp_cpu_get_cycle_count() - start);
+}
+#endif
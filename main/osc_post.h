@@ -0,0 +1,65 @@
+/**
+ * @file osc_post.h
+ * @brief Header file for the block post-processing stage (gain, mixing and 16-bit conversion) of the oscillator module.
+ */
+
+#ifndef OSC_POST_H
+#define OSC_POST_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/**
+ * @brief Multiplies a block by a constant gain.
+ * @param in Input samples.
+ * @param out Output samples (may alias in).
+ * @param num_samples Number of samples.
+ * @param gain Gain to apply.
+ */
+void osc_post_scale_f32(const float *in, float *out, uint32_t num_samples, float gain);
+
+/**
+ * @brief Multiplies a block by a linearly ramping gain.
+ * @param in Input samples.
+ * @param out Output samples (may alias in).
+ * @param num_samples Number of samples.
+ * @param gain Gain applied to the first sample.
+ * @param step Gain increment per sample.
+ * @return float Gain for the sample following the block.
+ */
+float osc_post_ramp_f32(const float *in, float *out, uint32_t num_samples, float gain, float step);
+
+/**
+ * @brief Multiplies two blocks sample by sample (amplitude modulation).
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+void osc_post_mul_f32(const float *a, const float *b, float *out, uint32_t num_samples);
+
+/**
+ * @brief Adds two blocks sample by sample (mixing).
+ * @param a First input.
+ * @param b Second input.
+ * @param out Output samples (may alias a or b).
+ * @param num_samples Number of samples.
+ */
+void osc_post_mix_f32(const float *a, const float *b, float *out, uint32_t num_samples);
+
+/**
+ * @brief Converts a block to 16 bits, saturating instead of wrapping and truncating toward zero.
+ * @param in Input samples in 16-bit full scale.
+ * @param out Output samples.
+ * @param num_samples Number of samples.
+ */
+void osc_post_to_s16(const float *in, int16_t *out, uint32_t num_samples);
+
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+/**
+ * @brief Measures and logs the cycles per sample of each post stage, for the build's path and for the scalar loops.
+ */
+void osc_post_benchmark(void);
+#endif
+
+#endif
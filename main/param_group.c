@@ -0,0 +1,196 @@
+/**
+ * @file param_group.c
+ * @brief Implementation of group membership and the arm/commit staging of parameters.
+ *
+ * Every module sees a general-call REG_COMMON_FRAME_SYNC complete at the same instant and, as
+ * TDM slaves on the same WS, counts frames in lockstep from there. Taking that frame as the
+ * origin gives the modules a shared timeline, so a commit for frame N lands on the same TDM
+ * frame everywhere, to within the accuracy of the interpolated audio clock.
+ *
+ * A committed group waits in its own small ring rather than in the parameter event queue, so
+ * a commit up to a second ahead does not hold back other updates. The ring is passed along
+ * three tasks: the I2C task fills an entry, the audio task applies it when its frame comes
+ * round, and the settings worker then publishes it through the parameter store.
+ */
+
+#include "param_group.h"
+#include <stdatomic.h>
+#include "i2c_proto_group.h"
+#include "param_registry.h"
+#include "param_store.h"
+#include "audio_clock.h"
+#include "settings_worker.h"
+#include "esp_log.h"
+
+/** @brief Log tag. */
+static const char *TAG = "PARAM_GROUP";
+
+/** @brief Groups the module belongs to, bit n for group n + 1. */
+static uint8_t group_mask = 0;
+
+/** @brief audio_clock frame of the last frame sync. */
+static uint32_t group_epoch = 0;
+
+/** @brief Staged values, valid for the fields set in staged_fields. */
+static MenuParams_t staged;
+
+/** @brief Fields staged since the last commit, one bit per param_field_t. */
+static uint32_t staged_fields = 0;
+
+/**
+ * @brief A committed group waiting to be applied or published.
+ */
+typedef struct
+{
+    MenuParams_t values; ///< Committed values, valid for the fields set in fields
+    uint32_t fields;     ///< Committed fields, one bit per param_field_t
+    uint32_t frame;      ///< audio_clock frame on which the group takes effect
+} param_group_pending_t;
+
+/** @brief Committed groups, in commit order. */
+static param_group_pending_t pending[PARAM_GROUP_PENDING_LEN];
+
+/** @brief Number of groups committed; written by the I2C task only. */
+static atomic_uint pending_committed = 0;
+
+/** @brief Number of groups applied; written by the audio task only. */
+static atomic_uint pending_applied = 0;
+
+/** @brief Number of groups published; written by the settings worker only. */
+static atomic_uint pending_published = 0;
+
+/**
+ * @brief Sets the groups the module belongs to.
+ * @param mask Bit n set for membership of group n + 1.
+ */
+void param_group_set_mask(uint8_t mask)
+{
+    group_mask = mask;
+}
+
+/**
+ * @brief Checks whether a group command is addressed to this module.
+ * @param group Group number from the command; I2C_PROTO_GROUP_ALL matches every module.
+ * @return bool True if the module is a member.
+ */
+bool param_group_member(uint8_t group)
+{
+    if (group == I2C_PROTO_GROUP_ALL)
+        return true;
+    return group <= 8 && (group_mask & (1u << (group - 1)));
+}
+
+/**
+ * @brief Sets the frame that commit frames are counted from.
+ * @param frame audio_clock frame on which REG_COMMON_FRAME_SYNC completed.
+ */
+void param_group_sync(uint32_t frame)
+{
+    group_epoch = frame;
+}
+
+/**
+ * @brief Stages parameters until the next commit; later values for the same parameter replace earlier ones.
+ * @param ids Parameter IDs; unknown IDs are skipped.
+ * @param values Protocol values, one per ID.
+ * @param count Number of entries.
+ */
+void param_group_arm(const ParamId_t *ids, const ParamValue_t *values, uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        int field = param_registry_find(ids[i]);
+        if (field < 0)
+            continue;
+        param_set(&staged, field, param_from_wire(field, values[i]));
+        staged_fields |= 1u << field;
+    }
+}
+
+/**
+ * @brief Schedules the staged parameters for the audio task to apply on a common frame, then clears them.
+ * @param frame Commit frame, counted from the frame given to param_group_sync().
+ */
+void param_group_commit(uint32_t frame)
+{
+    if (!staged_fields)
+        return;
+    unsigned committed = atomic_load_explicit(&pending_committed, memory_order_relaxed);
+    if (committed - atomic_load_explicit(&pending_published, memory_order_acquire) >= PARAM_GROUP_PENDING_LEN)
+    {
+        ESP_LOGW(TAG, "%d commits already waiting, commit ignored", PARAM_GROUP_PENDING_LEN);
+        return;
+    }
+    uint32_t target = group_epoch + frame;
+    uint32_t earliest = audio_clock_event_frame();
+    int32_t ahead = (int32_t)(target - earliest);
+    if (ahead < 0 || ahead > PARAM_GROUP_MAX_AHEAD_FRAMES)
+    {
+        ESP_LOGW(TAG, "Commit frame %lu is %ld frames from the earliest possible, clamped", (unsigned long)frame,
+                 (long)ahead);
+        target = earliest + (ahead < 0 ? 0 : PARAM_GROUP_MAX_AHEAD_FRAMES);
+    }
+    pending[committed % PARAM_GROUP_PENDING_LEN] = (param_group_pending_t){
+        .values = staged,
+        .fields = staged_fields,
+        .frame = target,
+    };
+    atomic_store_explicit(&pending_committed, committed + 1, memory_order_release);
+    staged_fields = 0;
+}
+
+/**
+ * @brief Returns the frame of the oldest committed group that has not been applied. Audio task only.
+ * @param frame Receives the audio_clock frame on which the group takes effect.
+ * @return bool True if a group is waiting.
+ */
+bool param_group_peek(uint32_t *frame)
+{
+    unsigned applied = atomic_load_explicit(&pending_applied, memory_order_relaxed);
+    if (atomic_load_explicit(&pending_committed, memory_order_acquire) == applied)
+        return false;
+    *frame = pending[applied % PARAM_GROUP_PENDING_LEN].frame;
+    return true;
+}
+
+/**
+ * @brief Applies the group returned by param_group_peek() and hands it to the settings worker to publish. Audio task only.
+ * @param params The parameters currently applied by the audio task; updated with the group.
+ */
+void param_group_apply(MenuParams_t *params)
+{
+    unsigned applied = atomic_load_explicit(&pending_applied, memory_order_relaxed);
+    const param_group_pending_t *group = &pending[applied % PARAM_GROUP_PENDING_LEN];
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        if (group->fields & (1u << field))
+            param_set(params, field, param_get(&group->values, field));
+    }
+    atomic_store_explicit(&pending_applied, applied + 1, memory_order_release);
+    settings_worker_post(SETTINGS_WORK_GROUP);
+}
+
+/**
+ * @brief Publishes every group the audio task has applied since the last call. Settings worker only.
+ *
+ * Each group is written with its own frame as the event frame. The audio task already has the
+ * values, so the events only matter if it resynced from the snapshot in the meantime.
+ */
+void param_group_publish_applied(void)
+{
+    unsigned published = atomic_load_explicit(&pending_published, memory_order_relaxed);
+    while (published != atomic_load_explicit(&pending_applied, memory_order_acquire))
+    {
+        const param_group_pending_t *group = &pending[published % PARAM_GROUP_PENDING_LEN];
+        MenuParams_t *params = param_store_write_begin();
+        for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+        {
+            // A write stamped after the group's frame reached the audio task after it and wins there too
+            if (!(group->fields & (1u << field)) || (int32_t)(param_store_field_frame(field) - group->frame) > 0)
+                continue;
+            param_set(params, field, param_get(&group->values, field));
+        }
+        param_store_write_end_at(group->frame);
+        atomic_store_explicit(&pending_published, ++published, memory_order_release);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ * @file param_group.h
+ * @brief Header file for group membership and the arm/commit staging of parameters applied on a shared frame.
+ *
+ * Functions are called from the I2C parser task unless marked otherwise.
+ */
+
+#ifndef PARAM_GROUP_H
+#define PARAM_GROUP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "module_i2c_proto.h"
+#include "user_actions.h"
+
+/** @brief Furthest a commit may be scheduled past the earliest possible frame (about one second). */
+#define PARAM_GROUP_MAX_AHEAD_FRAMES 48000
+
+/** @brief Committed groups that can wait to be applied and published. */
+#define PARAM_GROUP_PENDING_LEN 4
+
+/**
+ * @brief Sets the groups the module belongs to.
+ * @param mask Bit n set for membership of group n + 1.
+ */
+void param_group_set_mask(uint8_t mask);
+
+/**
+ * @brief Checks whether a group command is addressed to this module.
+ * @param group Group number from the command; I2C_PROTO_GROUP_ALL matches every module.
+ * @return bool True if the module is a member.
+ */
+bool param_group_member(uint8_t group);
+
+/**
+ * @brief Sets the frame that commit frames are counted from.
+ * @param frame audio_clock frame on which REG_COMMON_FRAME_SYNC completed.
+ */
+void param_group_sync(uint32_t frame);
+
+/**
+ * @brief Stages parameters until the next commit; later values for the same parameter replace earlier ones.
+ * @param ids Parameter IDs; unknown IDs are skipped.
+ * @param values Protocol values, one per ID.
+ * @param count Number of entries.
+ */
+void param_group_arm(const ParamId_t *ids, const ParamValue_t *values, uint8_t count);
+
+/**
+ * @brief Schedules the staged parameters for the audio task to apply on a common frame, then clears them.
+ * @param frame Commit frame, counted from the frame given to param_group_sync().
+ *
+ * A frame that can no longer be met is moved to the earliest frame that can, and one further
+ * ahead than PARAM_GROUP_MAX_AHEAD_FRAMES is pulled in to that limit. Nothing is published
+ * until the audio task has applied the group. If PARAM_GROUP_PENDING_LEN commits are already
+ * waiting, the commit is ignored and the staged parameters stay armed for the next one.
+ */
+void param_group_commit(uint32_t frame);
+
+/**
+ * @brief Returns the frame of the oldest committed group that has not been applied. Audio task only.
+ * @param frame Receives the audio_clock frame on which the group takes effect.
+ * @return bool True if a group is waiting.
+ */
+bool param_group_peek(uint32_t *frame);
+
+/**
+ * @brief Applies the group returned by param_group_peek() and hands it to the settings worker to publish. Audio task only.
+ * @param params The parameters currently applied by the audio task; updated with the group.
+ */
+void param_group_apply(MenuParams_t *params);
+
+/**
+ * @brief Publishes every group the audio task has applied since the last call. Settings worker only.
+ *
+ * A parameter written with a later event frame in the meantime keeps that value, as it does on
+ * the audio side, so the snapshot, read-back and NVS always end up where the audio is.
+ */
+void param_group_publish_applied(void);
+
+#endif
@@ -0,0 +1,32 @@
+/**
+ * @file param_readback.c
+ * @brief Implementation of the I2C read-back of the parameters.
+ *
+ * The parameter store calls this on every publish, with its writer lock held, so the response
+ * buffer always holds the published parameters and a read from the controller only has to
+ * pick a buffer. The dump is one batch entry per registry field; a REG_COMMON_GET_PARAM read
+ * is answered with the matching entry from it.
+ */
+
+#include "param_readback.h"
+#include "i2c_link.h"
+#include "i2c_proto_batch.h"
+#include "param_registry.h"
+
+/**
+ * @brief Rebuilds the REG_COMMON_PARAM_DUMP response, from which REG_COMMON_GET_PARAM reads are also answered. Called by the parameter store on every publish.
+ * @param params The parameters just published.
+ */
+void param_readback_store(const MenuParams_t *params)
+{
+    ParamId_t ids[PARAM_FIELD_COUNT];
+    ParamValue_t values[PARAM_FIELD_COUNT];
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        ids[field] = param_registry[field].id;
+        values[field] = param_to_wire(field, param_get(params, field));
+    }
+    uint8_t buf[1 + PARAM_FIELD_COUNT * I2C_PROTO_BATCH_ENTRY_LEN];
+    int len = i2c_proto_pack_set_param_batch(ids, values, PARAM_FIELD_COUNT, buf, sizeof(buf));
+    i2c_link_set_response(REG_COMMON_PARAM_DUMP, buf, len);
+}
@@ -0,0 +1,17 @@
+/**
+ * @file param_readback.h
+ * @brief Header file for the I2C read-back of the parameters, rebuilt by the parameter store on every publish.
+ */
+
+#ifndef PARAM_READBACK_H
+#define PARAM_READBACK_H
+
+#include "user_actions.h"
+
+/**
+ * @brief Rebuilds the REG_COMMON_PARAM_DUMP response, from which REG_COMMON_GET_PARAM reads are also answered. Called by the parameter store on every publish.
+ * @param params The parameters just published.
+ */
+void param_readback_store(const MenuParams_t *params);
+
+#endif
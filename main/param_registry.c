@@ -0,0 +1,257 @@
+/**
+ * @file param_registry.c
+ * @brief Implementation of the oscillator parameter registry.
+ *
+ * Adding a parameter means adding a MenuParams_t field, a param_field_t entry and one row
+ * below; I2C, NVS, the menu actions, reset and the event queue all work from this table.
+ */
+
+#include "param_registry.h"
+#include <stddef.h>
+#include "sdkconfig.h"
+
+/** @brief Every parameter, indexed by param_field_t. */
+const param_desc_t param_registry[PARAM_FIELD_COUNT] = {
+    [PARAM_FIELD_PITCH] = {
+        .id = PARAM_OSC_FREQUENCY_PITCH,
+        .type = PARAM_TYPE_U8,
+        .offset = offsetof(MenuParams_t, frequency_pitch),
+        .min = 0,
+        .max = 127,
+        .def = 69,
+        .step = 1,
+        .smooth_ms = CONFIG_OSC_SMOOTH_PITCH_MS,
+        .nvs_key = "freq_pitch",
+    },
+    [PARAM_FIELD_FINE] = {
+        .id = PARAM_OSC_FREQUENCY_FINE,
+        .type = PARAM_TYPE_S16,
+        .offset = offsetof(MenuParams_t, frequency_fine),
+        .min = -100,
+        .max = 100,
+        .def = 0,
+        .step = 1,
+        .smooth_ms = CONFIG_OSC_SMOOTH_PITCH_MS,
+        .nvs_key = "freq_fine",
+    },
+    [PARAM_FIELD_WAVEFORM] = {
+        .id = PARAM_OSC_WAVEFORM,
+        .type = PARAM_TYPE_ENUM,
+        .flags = PARAM_FLAG_WRAP,
+        .offset = offsetof(MenuParams_t, waveform),
+        .min = OSC_WAVE_SINE,
+        .max = OSC_WAVE_PULSE,
+        .def = OSC_WAVE_SINE,
+        .step = 1,
+        .nvs_key = "waveform",
+    },
+    [PARAM_FIELD_LEVEL] = {
+        .id = PARAM_OSC_LEVEL,
+        .type = PARAM_TYPE_U16,
+        .offset = offsetof(MenuParams_t, level),
+        .min = 0,
+        .max = 65535,
+        .def = 65535,
+        .step = 655,
+        .smooth_ms = CONFIG_OSC_SMOOTH_LEVEL_MS,
+        .nvs_key = "level",
+    },
+    [PARAM_FIELD_PW] = {
+        .id = PARAM_OSC_PW,
+        .type = PARAM_TYPE_U16,
+        .offset = offsetof(MenuParams_t, pulse_width),
+        .min = 0,
+        .max = 65535,
+        .def = 32768,
+        .step = 655,
+        .smooth_ms = CONFIG_OSC_SMOOTH_PW_MS,
+        .nvs_key = "pulse_width",
+    },
+    [PARAM_FIELD_AMP_MOD_SLOT] = {
+        .id = PARAM_OSC_AMP_MOD_SLOT,
+        .type = PARAM_TYPE_U8,
+        .flags = PARAM_FLAG_OFF,
+        .offset = offsetof(MenuParams_t, amp_mod_slot),
+        .min = 0,
+        .max = 15,
+        .def = PARAM_VALUE_OFF,
+        .step = 1,
+        .nvs_key = "amp_mod_slot",
+    },
+    [PARAM_FIELD_FREQ_MOD_SLOT] = {
+        .id = PARAM_OSC_FREQ_MOD_SLOT,
+        .type = PARAM_TYPE_U8,
+        .flags = PARAM_FLAG_OFF,
+        .offset = offsetof(MenuParams_t, freq_mod_slot),
+        .min = 0,
+        .max = 15,
+        .def = PARAM_VALUE_OFF,
+        .step = 1,
+        .nvs_key = "freq_mod_slot",
+    },
+    [PARAM_FIELD_SYNC_SLOT] = {
+        .id = PARAM_OSC_SYNC_SOURCE_SLOT,
+        .type = PARAM_TYPE_U8,
+        .flags = PARAM_FLAG_OFF,
+        .offset = offsetof(MenuParams_t, sync_source_slot),
+        .min = 0,
+        .max = 15,
+        .def = PARAM_VALUE_OFF,
+        .step = 1,
+        .nvs_key = "sync_slot",
+    },
+};
+
+/** @brief Maps protocol ID offsets from PARAM_RANGE_OSC to param_field_t + 1 (0 for none). */
+static const uint8_t param_index_by_id[] = {
+    [PARAM_OSC_FREQUENCY_PITCH - PARAM_RANGE_OSC] = PARAM_FIELD_PITCH + 1,
+    [PARAM_OSC_FREQUENCY_FINE - PARAM_RANGE_OSC] = PARAM_FIELD_FINE + 1,
+    [PARAM_OSC_WAVEFORM - PARAM_RANGE_OSC] = PARAM_FIELD_WAVEFORM + 1,
+    [PARAM_OSC_LEVEL - PARAM_RANGE_OSC] = PARAM_FIELD_LEVEL + 1,
+    [PARAM_OSC_PW - PARAM_RANGE_OSC] = PARAM_FIELD_PW + 1,
+    [PARAM_OSC_AMP_MOD_SLOT - PARAM_RANGE_OSC] = PARAM_FIELD_AMP_MOD_SLOT + 1,
+    [PARAM_OSC_FREQ_MOD_SLOT - PARAM_RANGE_OSC] = PARAM_FIELD_FREQ_MOD_SLOT + 1,
+    [PARAM_OSC_SYNC_SOURCE_SLOT - PARAM_RANGE_OSC] = PARAM_FIELD_SYNC_SLOT + 1,
+};
+
+/**
+ * @brief Finds a parameter by protocol ID.
+ * @param id The protocol parameter ID.
+ * @return int The param_field_t index, or -1 if the ID is not an oscillator parameter.
+ */
+int param_registry_find(ParamId_t id)
+{
+    if (id < PARAM_RANGE_OSC || (size_t)(id - PARAM_RANGE_OSC) >= sizeof(param_index_by_id))
+        return -1;
+    return (int)param_index_by_id[id - PARAM_RANGE_OSC] - 1;
+}
+
+/**
+ * @brief Reads a parameter.
+ * @param params The parameters.
+ * @param field The parameter to read.
+ * @return int32_t The value.
+ */
+int32_t param_get(const MenuParams_t *params, param_field_t field)
+{
+    const param_desc_t *desc = &param_registry[field];
+    const void *ptr = (const uint8_t *)params + desc->offset;
+    switch (desc->type)
+    {
+    case PARAM_TYPE_U8:
+        return *(const uint8_t *)ptr;
+    case PARAM_TYPE_S16:
+        return *(const int16_t *)ptr;
+    case PARAM_TYPE_U16:
+        return *(const uint16_t *)ptr;
+    case PARAM_TYPE_ENUM:
+        return *(const OscWaveform_t *)ptr;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Writes a parameter, clamped to its range.
+ * @param params The parameters.
+ * @param field The parameter to write.
+ * @param value The new value.
+ */
+void param_set(MenuParams_t *params, param_field_t field, int32_t value)
+{
+    const param_desc_t *desc = &param_registry[field];
+    if (!((desc->flags & PARAM_FLAG_OFF) && value == PARAM_VALUE_OFF))
+        value = value < desc->min ? desc->min : (value > desc->max ? desc->max : value);
+    void *ptr = (uint8_t *)params + desc->offset;
+    switch (desc->type)
+    {
+    case PARAM_TYPE_U8:
+        *(uint8_t *)ptr = (uint8_t)value;
+        break;
+    case PARAM_TYPE_S16:
+        *(int16_t *)ptr = (int16_t)value;
+        break;
+    case PARAM_TYPE_U16:
+        *(uint16_t *)ptr = (uint16_t)value;
+        break;
+    case PARAM_TYPE_ENUM:
+        *(OscWaveform_t *)ptr = (OscWaveform_t)value;
+        break;
+    }
+}
+
+/**
+ * @brief Steps a parameter by its menu increment, clamping or wrapping as described by its flags.
+ * @param params The parameters.
+ * @param field The parameter to step.
+ * @param dir +1 to step up, -1 to step down.
+ */
+void param_step(MenuParams_t *params, param_field_t field, int dir)
+{
+    const param_desc_t *desc = &param_registry[field];
+    int32_t value = param_get(params, field);
+    if ((desc->flags & PARAM_FLAG_OFF) && value == PARAM_VALUE_OFF)
+        value = dir > 0 ? desc->min : desc->max;
+    else if ((desc->flags & PARAM_FLAG_OFF) && value == (dir > 0 ? desc->max : desc->min))
+        value = PARAM_VALUE_OFF;
+    else
+    {
+        value += dir * desc->step;
+        if (desc->flags & PARAM_FLAG_WRAP)
+            value = value > desc->max ? desc->min : (value < desc->min ? desc->max : value);
+    }
+    param_set(params, field, value);
+}
+
+/**
+ * @brief Sets every parameter to its default.
+ * @param params The parameters.
+ */
+void param_set_defaults(MenuParams_t *params)
+{
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+        param_set(params, field, param_registry[field].def);
+}
+
+/**
+ * @brief Converts a protocol value into a parameter value.
+ * @param field The parameter.
+ * @param value The protocol value.
+ * @return int32_t The parameter value.
+ */
+int32_t param_from_wire(param_field_t field, ParamValue_t value)
+{
+    switch (param_registry[field].type)
+    {
+    case PARAM_TYPE_S16:
+        return value.s16[0];
+    case PARAM_TYPE_U16:
+        return value.u16[0];
+    default:
+        return value.u8[0];
+    }
+}
+
+/**
+ * @brief Converts a parameter value into a protocol value.
+ * @param field The parameter.
+ * @param value The parameter value.
+ * @return ParamValue_t The protocol value, with unused bytes zeroed.
+ */
+ParamValue_t param_to_wire(param_field_t field, int32_t value)
+{
+    ParamValue_t wire = {.u32 = 0};
+    switch (param_registry[field].type)
+    {
+    case PARAM_TYPE_S16:
+        wire.s16[0] = value;
+        break;
+    case PARAM_TYPE_U16:
+        wire.u16[0] = value;
+        break;
+    default:
+        wire.u8[0] = value;
+        break;
+    }
+    return wire;
+}
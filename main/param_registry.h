@@ -0,0 +1,123 @@
+/**
+ * @file param_registry.h
+ * @brief Header file for the table describing every oscillator parameter, shared by I2C, NVS, menu and reset handling.
+ */
+
+#ifndef PARAM_REGISTRY_H
+#define PARAM_REGISTRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "module_i2c_proto.h"
+#include "user_actions.h"
+
+/**
+ * @brief Oscillator parameters, indexing the registry.
+ */
+typedef enum
+{
+    PARAM_FIELD_PITCH,         ///< frequency_pitch
+    PARAM_FIELD_FINE,          ///< frequency_fine
+    PARAM_FIELD_WAVEFORM,      ///< waveform
+    PARAM_FIELD_LEVEL,         ///< level
+    PARAM_FIELD_PW,            ///< pulse_width
+    PARAM_FIELD_AMP_MOD_SLOT,  ///< amp_mod_slot
+    PARAM_FIELD_FREQ_MOD_SLOT, ///< freq_mod_slot
+    PARAM_FIELD_SYNC_SLOT,     ///< sync_source_slot
+    PARAM_FIELD_COUNT
+} param_field_t;
+
+/**
+ * @brief Storage type of a parameter in MenuParams_t.
+ */
+typedef enum
+{
+    PARAM_TYPE_U8,   ///< uint8_t; u8[0] on the wire
+    PARAM_TYPE_S16,  ///< int16_t; s16[0] on the wire
+    PARAM_TYPE_U16,  ///< uint16_t; u16[0] on the wire
+    PARAM_TYPE_ENUM, ///< OscWaveform_t; u8[0] on the wire and in NVS
+} param_type_t;
+
+/** @brief Flag: stepping past either end of the range wraps around. */
+#define PARAM_FLAG_WRAP (1u << 0)
+
+/** @brief Flag: 0xFF is also valid and means "off", stepped to between max and min. */
+#define PARAM_FLAG_OFF (1u << 1)
+
+/** @brief Value of a PARAM_FLAG_OFF parameter that is switched off. */
+#define PARAM_VALUE_OFF 0xFF
+
+/**
+ * @brief Description of one parameter.
+ */
+typedef struct
+{
+    ParamId_t id;          ///< Protocol parameter ID (PARAM_OSC_*)
+    uint8_t type;          ///< param_type_t of the MenuParams_t field
+    uint8_t flags;         ///< PARAM_FLAG_* flags
+    uint16_t offset;       ///< offsetof() the field in MenuParams_t
+    int32_t min;           ///< Lowest value
+    int32_t max;           ///< Highest value
+    int32_t def;           ///< Default value
+    int32_t step;          ///< Menu up/down increment
+    uint16_t smooth_ms;    ///< Smoothing time the audio task passes to osc_set_smoothing() (0 for a step)
+    const char *nvs_key;   ///< NVS key in the "oscillator" namespace
+} param_desc_t;
+
+/** @brief Every parameter, indexed by param_field_t. */
+extern const param_desc_t param_registry[PARAM_FIELD_COUNT];
+
+/**
+ * @brief Finds a parameter by protocol ID.
+ * @param id The protocol parameter ID.
+ * @return int The param_field_t index, or -1 if the ID is not an oscillator parameter.
+ */
+int param_registry_find(ParamId_t id);
+
+/**
+ * @brief Reads a parameter.
+ * @param params The parameters.
+ * @param field The parameter to read.
+ * @return int32_t The value.
+ */
+int32_t param_get(const MenuParams_t *params, param_field_t field);
+
+/**
+ * @brief Writes a parameter, clamped to its range.
+ * @param params The parameters.
+ * @param field The parameter to write.
+ * @param value The new value.
+ */
+void param_set(MenuParams_t *params, param_field_t field, int32_t value);
+
+/**
+ * @brief Steps a parameter by its menu increment, clamping or wrapping as described by its flags.
+ * @param params The parameters.
+ * @param field The parameter to step.
+ * @param dir +1 to step up, -1 to step down.
+ */
+void param_step(MenuParams_t *params, param_field_t field, int dir);
+
+/**
+ * @brief Sets every parameter to its default.
+ * @param params The parameters.
+ */
+void param_set_defaults(MenuParams_t *params);
+
+/**
+ * @brief Converts a protocol value into a parameter value.
+ * @param field The parameter.
+ * @param value The protocol value.
+ * @return int32_t The parameter value.
+ */
+int32_t param_from_wire(param_field_t field, ParamValue_t value);
+
+/**
+ * @brief Converts a parameter value into a protocol value.
+ * @param field The parameter.
+ * @param value The parameter value.
+ * @return ParamValue_t The protocol value, with unused bytes zeroed.
+ */
+ParamValue_t param_to_wire(param_field_t field, int32_t value);
+
+#endif
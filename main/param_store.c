@@ -0,0 +1,258 @@
+/**
+ * @file param_store.c
+ * @brief Implementation of the seqlock-published oscillator parameter snapshot.
+ *
+ * Writers (I2C, menu actions, NVS/favorite loads) are serialised by a mutex and edit a private
+ * copy, then publish it under a sequence counter that is odd while the snapshot is being copied.
+ * The audio task reads the counter, copies the snapshot and checks the counter again; if a
+ * publish overlapped it keeps the snapshot it already has, so the real-time path never blocks
+ * and never sees a mix of old and new fields.
+ *
+ * Alongside the snapshot, each publish queues one event per changed field, all stamped with
+ * the same future sample frame, into a single-producer/single-consumer ring. The writer lock
+ * makes the writers a single producer. The audio task splits its block at each event's frame,
+ * which gives sample-accurate changes; if the ring overflows it falls back to the snapshot.
+ * Events only become visible after their values are published, so every event behind a given
+ * head is already in the snapshot and a resync can drop exactly those.
+ */
+
+#include "param_store.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "audio_clock.h"
+#include "warm_cache.h"
+#include "param_readback.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/** @brief Writers' copy of the parameters, guarded by param_lock. */
+static MenuParams_t param_work;
+
+/** @brief Snapshot read by the audio task. */
+static MenuParams_t param_published;
+
+/** @brief Publish sequence counter; odd while param_published is being written. */
+static atomic_uint param_seq = 0;
+
+/** @brief Parameter event ring. */
+static param_event_t param_events[PARAM_EVENT_QUEUE_LEN];
+
+/** @brief Number of events pushed; written by the writers only. */
+static atomic_uint param_event_head = 0;
+
+/** @brief Number of events consumed; written by the audio task only. */
+static atomic_uint param_event_tail = 0;
+
+/** @brief Event frame of the last change of each field, guarded by param_lock. */
+static uint32_t param_field_frames[PARAM_FIELD_COUNT];
+
+/** @brief Set when a publish could not queue its events. */
+static atomic_bool param_event_overflow = false;
+
+/** @brief Serialises writers. */
+static SemaphoreHandle_t param_lock = NULL;
+
+/** @brief Storage for param_lock. */
+static StaticSemaphore_t param_lock_buf;
+
+/**
+ * @brief Copies param_work into the published snapshot under the sequence counter.
+ */
+static void param_store_publish(void)
+{
+    unsigned seq = atomic_load_explicit(&param_seq, memory_order_relaxed);
+    atomic_store_explicit(&param_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&param_published, &param_work, sizeof(param_published));
+    atomic_store_explicit(&param_seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Writes an event for every field of param_work that differs from the published snapshot.
+ * @param frame Frame on which the changes take effect.
+ * @return int Number of events written past the head, to be made visible by advancing it, or -1
+ *         if the queue had no room for all of them.
+ */
+static int param_store_stage_changes(uint32_t frame)
+{
+    unsigned head = atomic_load_explicit(&param_event_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&param_event_tail, memory_order_acquire);
+    unsigned count = 0;
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        int32_t value = param_get(&param_work, field);
+        if (value == param_get(&param_published, field))
+            continue;
+        if (head + count - tail >= PARAM_EVENT_QUEUE_LEN)
+            return -1;
+        param_events[(head + count) % PARAM_EVENT_QUEUE_LEN] = (param_event_t){
+            .frame = frame,
+            .value = value,
+            .field = field,
+        };
+        count++;
+    }
+    return (int)count;
+}
+
+/**
+ * @brief Creates the writer lock and publishes the default parameters, or the pre-reset ones after a warm restart. Call before any other task starts.
+ */
+void param_store_init(void)
+{
+    param_lock = xSemaphoreCreateMutexStatic(&param_lock_buf);
+    param_set_defaults(&param_work);
+    // After a warm restart the pre-reset state is in RTC memory and takes effect from the first sample
+    warm_cache_load(&param_work);
+    param_store_publish();
+    warm_cache_store(&param_work);
+    param_readback_store(&param_work);
+}
+
+/**
+ * @brief Starts a parameter update, blocking other writers until param_store_write_end().
+ * @return MenuParams_t* The writers' copy of the parameters, to be modified in place.
+ */
+MenuParams_t *param_store_write_begin(void)
+{
+    xSemaphoreTake(param_lock, portMAX_DELAY);
+    return &param_work;
+}
+
+/**
+ * @brief Publishes the modified parameters as one consistent snapshot and releases the writer lock.
+ *
+ * Each changed field is also queued as an event stamped with audio_clock_event_frame(), so the
+ * audio task applies all of them together on that exact frame.
+ */
+void param_store_write_end(void)
+{
+    param_store_write_end_at(audio_clock_event_frame());
+}
+
+/**
+ * @brief Like param_store_write_end(), but the changes take effect on the given frame.
+ * @param frame audio_clock frame for the queued events; one already rendered is applied at the start of the next block.
+ */
+void param_store_write_end_at(uint32_t frame)
+{
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        if (param_get(&param_work, field) != param_get(&param_published, field))
+            param_field_frames[field] = frame;
+    }
+    // Staged against the old snapshot, but only pushed once the new one is published
+    int staged = param_store_stage_changes(frame);
+    param_store_publish();
+    if (staged > 0)
+    {
+        unsigned head = atomic_load_explicit(&param_event_head, memory_order_relaxed);
+        atomic_store_explicit(&param_event_head, head + (unsigned)staged, memory_order_release);
+    }
+    warm_cache_store(&param_work);
+    param_readback_store(&param_work);
+    // Raised after the publish so a resync always finds these values in the snapshot
+    if (staged < 0)
+        atomic_store_explicit(&param_event_overflow, true, memory_order_release);
+    xSemaphoreGive(param_lock);
+}
+
+/**
+ * @brief Returns the event frame of the last write that changed a parameter. Writers only, between param_store_write_begin() and param_store_write_end().
+ * @param field The parameter.
+ * @return uint32_t audio_clock frame the change was stamped with (0 if never written).
+ */
+uint32_t param_store_field_frame(param_field_t field)
+{
+    return param_field_frames[field];
+}
+
+/**
+ * @brief Copies the current parameters for a control task, waiting for any update in progress.
+ * @param out Destination for the parameters.
+ */
+void param_store_get(MenuParams_t *out)
+{
+    xSemaphoreTake(param_lock, portMAX_DELAY);
+    *out = param_work;
+    xSemaphoreGive(param_lock);
+}
+
+/**
+ * @brief Copies the published snapshot without blocking, for the audio task.
+ * @param out Destination for the snapshot; left untouched if the read fails.
+ * @return bool True if a consistent snapshot was copied, false if an update was being published.
+ */
+bool param_store_read(MenuParams_t *out)
+{
+    MenuParams_t copy;
+    unsigned seq = atomic_load_explicit(&param_seq, memory_order_acquire);
+    if (seq & 1)
+        return false;
+    memcpy(&copy, &param_published, sizeof(copy));
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&param_seq, memory_order_relaxed) != seq)
+        return false;
+    *out = copy;
+    return true;
+}
+
+/**
+ * @brief Returns the oldest queued parameter event without removing it. Audio task only.
+ * @param ev Receives the event.
+ * @return bool True if an event was queued.
+ */
+bool param_store_peek_event(param_event_t *ev)
+{
+    unsigned tail = atomic_load_explicit(&param_event_tail, memory_order_relaxed);
+    if (atomic_load_explicit(&param_event_head, memory_order_acquire) == tail)
+        return false;
+    *ev = param_events[tail % PARAM_EVENT_QUEUE_LEN];
+    return true;
+}
+
+/**
+ * @brief Removes the event returned by param_store_peek_event(). Audio task only.
+ */
+void param_store_pop_event(void)
+{
+    unsigned tail = atomic_load_explicit(&param_event_tail, memory_order_relaxed);
+    atomic_store_explicit(&param_event_tail, tail + 1, memory_order_release);
+}
+
+/**
+ * @brief Reloads the published snapshot and discards the queued events it already contains. Audio task only.
+ * @param out Destination for the snapshot; left untouched if the read fails.
+ * @return bool True on success, false if an update was being published and nothing was changed.
+ *
+ * The head is captured before the snapshot is read, so only events whose values the snapshot
+ * is known to hold are dropped; events pushed meanwhile stay queued and are applied as usual.
+ */
+bool param_store_resync(MenuParams_t *out)
+{
+    unsigned head = atomic_load_explicit(&param_event_head, memory_order_acquire);
+    if (!param_store_read(out))
+        return false;
+    atomic_store_explicit(&param_event_tail, head, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Reports and clears an event queue overflow. Audio task only.
+ * @return bool True if events were lost since the last call, so the snapshot must be reloaded.
+ */
+bool param_store_take_resync(void)
+{
+    return atomic_exchange_explicit(&param_event_overflow, false, memory_order_acquire);
+}
+
+/**
+ * @brief Applies a parameter event to a parameter set.
+ * @param params The parameters to update.
+ * @param ev The event to apply.
+ */
+void param_store_apply_event(MenuParams_t *params, const param_event_t *ev)
+{
+    if (ev->field < PARAM_FIELD_COUNT)
+        param_set(params, ev->field, ev->value);
+}
@@ -0,0 +1,111 @@
+/**
+ * @file param_store.h
+ * @brief Header file for the seqlock-published oscillator parameter snapshot and the timestamped
+ *        parameter event queue shared by the control tasks and the audio task.
+ */
+
+#ifndef PARAM_STORE_H
+#define PARAM_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "user_actions.h"
+#include "param_registry.h"
+
+/** @brief Capacity of the parameter event queue. */
+#define PARAM_EVENT_QUEUE_LEN 32
+
+/**
+ * @brief One parameter change, to be applied on a given sample frame.
+ */
+typedef struct
+{
+    uint32_t frame; ///< audio_clock frame on which the new value takes effect
+    int32_t value;  ///< New value of the field
+    uint8_t field;  ///< param_field_t of the changed field
+} param_event_t;
+
+/**
+ * @brief Creates the writer lock and publishes the default parameters, or the pre-reset ones after a warm restart. Call before any other task starts.
+ */
+void param_store_init(void);
+
+/**
+ * @brief Starts a parameter update, blocking other writers until param_store_write_end().
+ * @return MenuParams_t* The writers' copy of the parameters, to be modified in place.
+ */
+MenuParams_t *param_store_write_begin(void);
+
+/**
+ * @brief Publishes the modified parameters as one consistent snapshot and releases the writer lock.
+ *
+ * Each changed field is also queued as an event stamped with audio_clock_event_frame(), so the
+ * audio task applies all of them together on that exact frame.
+ */
+void param_store_write_end(void);
+
+/**
+ * @brief Like param_store_write_end(), but the changes take effect on the given frame.
+ * @param frame audio_clock frame for the queued events; one already rendered is applied at the start of the next block.
+ *
+ * Events are applied in queue order, so a frame far ahead also holds back any later update
+ * until it has passed.
+ */
+void param_store_write_end_at(uint32_t frame);
+
+/**
+ * @brief Returns the event frame of the last write that changed a parameter. Writers only, between param_store_write_begin() and param_store_write_end().
+ * @param field The parameter.
+ * @return uint32_t audio_clock frame the change was stamped with (0 if never written).
+ */
+uint32_t param_store_field_frame(param_field_t field);
+
+/**
+ * @brief Copies the current parameters for a control task, waiting for any update in progress.
+ * @param out Destination for the parameters.
+ */
+void param_store_get(MenuParams_t *out);
+
+/**
+ * @brief Copies the published snapshot without blocking, for the audio task.
+ * @param out Destination for the snapshot; left untouched if the read fails.
+ * @return bool True if a consistent snapshot was copied, false if an update was being published.
+ */
+bool param_store_read(MenuParams_t *out);
+
+/**
+ * @brief Returns the oldest queued parameter event without removing it. Audio task only.
+ * @param ev Receives the event.
+ * @return bool True if an event was queued.
+ */
+bool param_store_peek_event(param_event_t *ev);
+
+/**
+ * @brief Removes the event returned by param_store_peek_event(). Audio task only.
+ */
+void param_store_pop_event(void);
+
+/**
+ * @brief Reloads the published snapshot and discards the queued events it already contains. Audio task only.
+ * @param out Destination for the snapshot; left untouched if the read fails.
+ * @return bool True on success, false if an update was being published and nothing was changed.
+ *
+ * The head is captured before the snapshot is read, so only events whose values the snapshot
+ * is known to hold are dropped; events pushed meanwhile stay queued and are applied as usual.
+ */
+bool param_store_resync(MenuParams_t *out);
+
+/**
+ * @brief Reports and clears an event queue overflow. Audio task only.
+ * @return bool True if events were lost since the last call, so the snapshot must be reloaded.
+ */
+bool param_store_take_resync(void);
+
+/**
+ * @brief Applies a parameter event to a parameter set.
+ * @param params The parameters to update.
+ * @param ev The event to apply.
+ */
+void param_store_apply_event(MenuParams_t *params, const param_event_t *ev);
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file preset_bank.c
+ * @brief Implementation of the indexed preset bank.
+ *
+ * Presets live in their own NVS namespace: each used slot has a small metadata blob (name
+ * hash, payload layout version, payload size and CRC) and a payload blob holding the name and
+ * a settings blob, so storing or clearing one preset rewrites only that slot's keys. The
+ * metadata is read into a RAM index once at startup, so finding, listing and validating
+ * presets never touches flash. Payloads are read only when a preset is recalled
+ * and the decoded parameters of the last few are cached in RAM, so recalling a recently used
+ * preset is a copy and a parameter-store publish.
+ */
+
+#include "preset_bank.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "nvs_flash.h"
+#include "param_registry.h"
+#include "param_store.h"
+#include "settings_blob.h"
+
+/** @brief NVS namespace of the bank. */
+#define PRESET_NAMESPACE "presets"
+
+/** @brief Layout version of a payload; 0 in the index marks an empty slot. */
+#define PRESET_PAYLOAD_VERSION 1
+
+/** @brief Log tag. */
+static const char *TAG = "PRESET";
+
+/**
+ * @brief Index entry of one slot, stored as the slot's metadata blob.
+ */
+typedef struct
+{
+    uint32_t name_hash; ///< FNV-1a hash of the name
+    uint32_t crc;       ///< CRC-32 of the stored payload bytes
+    uint16_t version;   ///< PRESET_PAYLOAD_VERSION, or 0 if the slot is empty
+    uint16_t size;      ///< Stored payload bytes
+} preset_index_entry_t;
+
+/**
+ * @brief Stored preset; only the valid part of params is written.
+ */
+typedef struct
+{
+    char name[PRESET_NAME_LEN]; ///< NUL-terminated name
+    settings_blob_t params;     ///< Preset parameters
+} preset_payload_t;
+
+/**
+ * @brief Decoded preset kept in RAM.
+ */
+typedef struct
+{
+    int16_t slot;        ///< Cached slot, or -1 if unused
+    uint32_t last_used;  ///< Value of cache_clock when last hit
+    MenuParams_t params; ///< Decoded parameters
+} preset_cache_entry_t;
+
+/** @brief In-RAM index of every slot's metadata. */
+static preset_index_entry_t bank_index[PRESET_BANK_SLOTS];
+
+/** @brief Scratch payload for reads, guarded by bank_lock; too large for the callers' stacks. */
+static preset_payload_t bank_payload;
+
+/** @brief Scratch payload for writes, owned by the single writer (init, then the settings worker). */
+static preset_payload_t store_payload;
+
+/** @brief Recently used presets. */
+static preset_cache_entry_t bank_cache[PRESET_CACHE_SLOTS] = {
+    [0 ... PRESET_CACHE_SLOTS - 1] = {.slot = -1},
+};
+
+/** @brief Use counter ordering the cache entries. */
+static uint32_t cache_clock = 0;
+
+/** @brief Guards the RAM index, the cache and reads; never held across an NVS write. */
+static SemaphoreHandle_t bank_lock = NULL;
+
+/** @brief Storage for bank_lock. */
+static StaticSemaphore_t bank_lock_buf;
+
+/**
+ * @brief Hashes a preset name.
+ * @param name The name.
+ * @return uint32_t FNV-1a hash.
+ */
+static uint32_t preset_name_hash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < PRESET_NAME_LEN && name[i]; i++)
+        hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+    return hash;
+}
+
+/**
+ * @brief Builds the NVS key of a slot's payload.
+ * @param slot The slot.
+ * @param key Destination, at least 8 bytes.
+ */
+static void preset_key(uint16_t slot, char *key)
+{
+    snprintf(key, 8, "p%03u", slot);
+}
+
+/**
+ * @brief Builds the NVS key of a slot's metadata.
+ * @param slot The slot.
+ * @param key Destination, at least 8 bytes.
+ */
+static void preset_meta_key(uint16_t slot, char *key)
+{
+    snprintf(key, 8, "m%03u", slot);
+}
+
+/**
+ * @brief Drops a slot from the cache.
+ * @param slot The slot.
+ */
+static void preset_cache_drop(uint16_t slot)
+{
+    for (int i = 0; i < PRESET_CACHE_SLOTS; i++)
+    {
+        if (bank_cache[i].slot == slot)
+            bank_cache[i].slot = -1;
+    }
+}
+
+/**
+ * @brief Empties a slot in RAM so readers stop using it while its keys are rewritten.
+ * @param slot The slot.
+ */
+static void preset_invalidate(uint16_t slot)
+{
+    xSemaphoreTake(bank_lock, portMAX_DELAY);
+    preset_cache_drop(slot);
+    memset(&bank_index[slot], 0, sizeof(bank_index[slot]));
+    xSemaphoreGive(bank_lock);
+}
+
+/**
+ * @brief Writes a preset's payload and metadata; called by the single writer without bank_lock.
+ * @param nvs Open NVS handle.
+ * @param slot The slot, already invalidated.
+ * @param name Preset name.
+ * @param params The parameters to store.
+ * @return esp_err_t Result of the writes and the commit.
+ */
+static esp_err_t preset_write(nvs_handle_t nvs, uint16_t slot, const char *name, const MenuParams_t *params)
+{
+    memset(&store_payload, 0, sizeof(store_payload));
+    strncpy(store_payload.name, name, PRESET_NAME_LEN - 1);
+    settings_blob_pack(params, &store_payload.params);
+    size_t size = offsetof(preset_payload_t, params) + settings_blob_size(&store_payload.params);
+    preset_index_entry_t entry = {
+        .name_hash = preset_name_hash(store_payload.name),
+        .crc = esp_rom_crc32_le(0, (const uint8_t *)&store_payload, size),
+        .version = PRESET_PAYLOAD_VERSION,
+        .size = size,
+    };
+    char key[8];
+    preset_key(slot, key);
+    esp_err_t err = nvs_set_blob(nvs, key, &store_payload, size);
+    if (err == ESP_OK)
+    {
+        // Written last: a payload without matching metadata fails validation instead of loading
+        preset_meta_key(slot, key);
+        err = nvs_set_blob(nvs, key, &entry, sizeof(entry));
+    }
+    if (err == ESP_OK)
+        err = nvs_commit(nvs);
+    if (err == ESP_OK)
+    {
+        xSemaphoreTake(bank_lock, portMAX_DELAY);
+        bank_index[slot] = entry;
+        xSemaphoreGive(bank_lock);
+    }
+    return err;
+}
+
+/**
+ * @brief Finds a slot for an imported favorite.
+ * @param preferred The slot the favorite used to have.
+ * @return int The preferred slot if it is free, else the first free slot, or -1 if the bank is full.
+ */
+static int preset_import_slot(uint16_t preferred)
+{
+    if (!bank_index[preferred].version)
+        return preferred;
+    for (int slot = 0; slot < PRESET_BANK_SLOTS; slot++)
+    {
+        if (!bank_index[slot].version)
+            return slot;
+    }
+    return -1;
+}
+
+/**
+ * @brief Copies the favorites saved by older firmware as raw parameter blobs into the bank.
+ *
+ * Each favorite goes to its old slot (0–3) if that is free, else to the first free slot. A
+ * legacy key is erased only once its favorite has been stored, so nothing is lost when it
+ * cannot be imported.
+ * @param bank Open handle of the bank namespace.
+ */
+static void preset_import_favorites(nvs_handle_t bank)
+{
+    nvs_handle_t legacy;
+    if (nvs_open("oscillator", NVS_READWRITE, &legacy) != ESP_OK)
+        return;
+    bool imported = false;
+    for (int fav = 0; fav < 4; fav++)
+    {
+        char key[16];
+        snprintf(key, sizeof(key), "fav_slot_%d", fav);
+        MenuParams_t params;
+        size_t size = sizeof(params);
+        if (nvs_get_blob(legacy, key, &params, &size) != ESP_OK)
+            continue;
+        int slot = preset_import_slot(fav);
+        if (size != sizeof(params) || slot < 0)
+        {
+            ESP_LOGW(TAG, "Kept legacy favorite %d: %s", fav + 1, slot < 0 ? "bank full" : "unknown layout");
+            continue;
+        }
+        char name[PRESET_NAME_LEN];
+        snprintf(name, sizeof(name), "Favorite %d", fav + 1);
+        if (preset_write(bank, slot, name, &params) != ESP_OK)
+            continue;
+        nvs_erase_key(legacy, key);
+        imported = true;
+    }
+    if (imported)
+    {
+        nvs_commit(legacy);
+        ESP_LOGI(TAG, "Imported legacy favorites");
+    }
+    nvs_close(legacy);
+}
+
+/**
+ * @brief Loads the preset index and imports the favorites of older firmware. Call once NVS is initialized.
+ */
+void preset_bank_init(void)
+{
+    bank_lock = xSemaphoreCreateMutexStatic(&bank_lock_buf);
+    memset(bank_index, 0, sizeof(bank_index));
+    nvs_handle_t nvs;
+    if (nvs_open(PRESET_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK)
+        return;
+    for (uint16_t slot = 0; slot < PRESET_BANK_SLOTS; slot++)
+    {
+        char key[8];
+        preset_meta_key(slot, key);
+        preset_index_entry_t entry;
+        size_t size = sizeof(entry);
+        // Metadata of another layout cannot describe its payload; leave the slot empty
+        if (nvs_get_blob(nvs, key, &entry, &size) == ESP_OK && size == sizeof(entry) &&
+            entry.version == PRESET_PAYLOAD_VERSION && entry.size <= sizeof(preset_payload_t))
+            bank_index[slot] = entry;
+    }
+    preset_import_favorites(nvs);
+    nvs_close(nvs);
+}
+
+/**
+ * @brief Reports whether a slot holds a preset.
+ * @param slot The slot.
+ * @return bool True if the slot is in use.
+ */
+bool preset_bank_used(uint16_t slot)
+{
+    return slot < PRESET_BANK_SLOTS && bank_index[slot].version != 0;
+}
+
+/**
+ * @brief Finds a preset by name.
+ * @param name The preset name.
+ * @return int The first slot whose name matches, or -1 if none does.
+ */
+int preset_bank_find(const char *name)
+{
+    uint32_t hash = preset_name_hash(name);
+    for (int slot = 0; slot < PRESET_BANK_SLOTS; slot++)
+    {
+        if (bank_index[slot].version && bank_index[slot].name_hash == hash)
+            return slot;
+    }
+    return -1;
+}
+
+/**
+ * @brief Stores a preset, replacing any preset already in the slot. Call from the settings worker only.
+ * @param slot The slot.
+ * @param name Preset name, truncated to PRESET_NAME_LEN - 1 characters.
+ * @param params The parameters to store.
+ * @return bool True if the preset was written.
+ */
+bool preset_bank_store(uint16_t slot, const char *name, const MenuParams_t *params)
+{
+    if (slot >= PRESET_BANK_SLOTS || !bank_lock)
+        return false;
+    nvs_handle_t nvs;
+    if (nvs_open(PRESET_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK)
+        return false;
+    preset_invalidate(slot);
+    esp_err_t err = preset_write(nvs, slot, name, params);
+    nvs_close(nvs);
+    return err == ESP_OK;
+}
+
+/**
+ * @brief Reads a preset, from the cache if it was used recently.
+ * @param slot The slot.
+ * @param params Filled with the preset's parameters; fields it does not hold keep their defaults.
+ * @return bool True if the slot holds a valid preset.
+ */
+bool preset_bank_get(uint16_t slot, MenuParams_t *params)
+{
+    if (!preset_bank_used(slot) || !bank_lock)
+        return false;
+    xSemaphoreTake(bank_lock, portMAX_DELAY);
+    // The slot may have been invalidated by a store or clear since the check above
+    const preset_index_entry_t entry = bank_index[slot];
+    if (!entry.version)
+    {
+        xSemaphoreGive(bank_lock);
+        return false;
+    }
+    cache_clock++;
+    preset_cache_entry_t *victim = &bank_cache[0];
+    for (int i = 0; i < PRESET_CACHE_SLOTS; i++)
+    {
+        if (bank_cache[i].slot == slot)
+        {
+            bank_cache[i].last_used = cache_clock;
+            *params = bank_cache[i].params;
+            xSemaphoreGive(bank_lock);
+            return true;
+        }
+        if (bank_cache[i].slot < 0 || (victim->slot >= 0 && bank_cache[i].last_used < victim->last_used))
+            victim = &bank_cache[i];
+    }
+    bool ok = false;
+    nvs_handle_t nvs;
+    if (nvs_open(PRESET_NAMESPACE, NVS_READONLY, &nvs) == ESP_OK)
+    {
+        char key[8];
+        preset_key(slot, key);
+        size_t size = sizeof(bank_payload);
+        MenuParams_t decoded;
+        param_set_defaults(&decoded);
+        ok = nvs_get_blob(nvs, key, &bank_payload, &size) == ESP_OK && size == entry.size &&
+             esp_rom_crc32_le(0, (const uint8_t *)&bank_payload, size) == entry.crc &&
+             settings_blob_unpack(&bank_payload.params, size - offsetof(preset_payload_t, params), &decoded);
+        nvs_close(nvs);
+        if (ok)
+        {
+            *victim = (preset_cache_entry_t){.slot = slot, .last_used = cache_clock, .params = decoded};
+            *params = decoded;
+        }
+        else
+        {
+            ESP_LOGW(TAG, "Preset %u failed validation", slot);
+        }
+    }
+    xSemaphoreGive(bank_lock);
+    return ok;
+}
+
+/**
+ * @brief Makes a preset the live parameters, applied together on one frame.
+ * @param slot The slot.
+ * @return bool True if the slot holds a valid preset.
+ */
+bool preset_bank_recall(uint16_t slot)
+{
+    MenuParams_t params;
+    if (!preset_bank_get(slot, &params))
+        return false;
+    *param_store_write_begin() = params;
+    param_store_write_end();
+    return true;
+}
+
+/**
+ * @brief Erases a preset. Call from the settings worker only.
+ * @param slot The slot.
+ */
+void preset_bank_clear(uint16_t slot)
+{
+    if (!preset_bank_used(slot) || !bank_lock)
+        return;
+    nvs_handle_t nvs;
+    if (nvs_open(PRESET_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK)
+        return;
+    preset_invalidate(slot);
+    // Metadata first: a payload left behind by a failed erase is never loaded
+    char key[8];
+    preset_meta_key(slot, key);
+    nvs_erase_key(nvs, key);
+    preset_key(slot, key);
+    nvs_erase_key(nvs, key);
+    nvs_commit(nvs);
+    nvs_close(nvs);
+}
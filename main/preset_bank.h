@@ -0,0 +1,71 @@
+/**
+ * @file preset_bank.h
+ * @brief Header file for the indexed preset bank stored in NVS, loaded on demand through a small RAM cache.
+ */
+
+#ifndef PRESET_BANK_H
+#define PRESET_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_actions.h"
+
+/** @brief Number of preset slots. */
+#define PRESET_BANK_SLOTS 128
+
+/** @brief Longest preset name, terminator included. */
+#define PRESET_NAME_LEN 16
+
+/** @brief Number of recently used presets kept decoded in RAM. */
+#define PRESET_CACHE_SLOTS 4
+
+/**
+ * @brief Loads the preset index and imports the favorites of older firmware. Call once NVS is initialized.
+ */
+void preset_bank_init(void);
+
+/**
+ * @brief Reports whether a slot holds a preset.
+ * @param slot The slot.
+ * @return bool True if the slot is in use.
+ */
+bool preset_bank_used(uint16_t slot);
+
+/**
+ * @brief Finds a preset by name.
+ * @param name The preset name.
+ * @return int The first slot whose name matches, or -1 if none does.
+ */
+int preset_bank_find(const char *name);
+
+/**
+ * @brief Stores a preset, replacing any preset already in the slot. Call from the settings worker only.
+ * @param slot The slot.
+ * @param name Preset name, truncated to PRESET_NAME_LEN - 1 characters.
+ * @param params The parameters to store.
+ * @return bool True if the preset was written.
+ */
+bool preset_bank_store(uint16_t slot, const char *name, const MenuParams_t *params);
+
+/**
+ * @brief Reads a preset, from the cache if it was used recently.
+ * @param slot The slot.
+ * @param params Filled with the preset's parameters; fields it does not hold keep their defaults.
+ * @return bool True if the slot holds a valid preset.
+ */
+bool preset_bank_get(uint16_t slot, MenuParams_t *params);
+
+/**
+ * @brief Makes a preset the live parameters, applied together on one frame.
+ * @param slot The slot.
+ * @return bool True if the slot holds a valid preset.
+ */
+bool preset_bank_recall(uint16_t slot);
+
+/**
+ * @brief Erases a preset. Call from the settings worker only.
+ * @param slot The slot.
+ */
+void preset_bank_clear(uint16_t slot);
+
+#endif
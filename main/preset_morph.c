@@ -0,0 +1,215 @@
+/**
+ * @file preset_morph.c
+ * @brief Implementation of the control-rate crossfade between two presets.
+ *
+ * Both presets are copied out of the preset bank when the morph starts, so running it never
+ * touches NVS. The audio task interpolates once per block: pitch (with fine tune, in cents),
+ * level and pulse width move continuously, and the waveform and modulation slots switch
+ * halfway. Level, pulse width and pitch changes are then smoothed per sample by the
+ * oscillator's ramps, so sweeping the position sounds continuous.
+ *
+ * The presets and source are published to the audio task through a sequence counter in the
+ * same way as the parameter store; a read that overlaps a restart keeps the previous copy.
+ */
+
+#include "preset_morph.h"
+#include <stdatomic.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "preset_bank.h"
+#include "param_store.h"
+#include "audio_clock.h"
+
+/**
+ * @brief Morph setup shared with the audio task.
+ */
+typedef struct
+{
+    bool running;   ///< Morph active
+    uint8_t source; ///< TDM slot or PRESET_MORPH_SOURCE_POSITION
+    MenuParams_t a; ///< Parameters at position 0
+    MenuParams_t b; ///< Parameters at position 65535
+} preset_morph_config_t;
+
+/** @brief Setup written by the control tasks. */
+static preset_morph_config_t morph_config;
+
+/** @brief Publish sequence counter for morph_config; odd while it is being written. */
+static atomic_uint morph_seq = 0;
+
+/** @brief Position used when no TDM slot drives the morph. */
+static atomic_uint morph_position = 0;
+
+/** @brief Position of the last block rendered, for preset_morph_stop(). */
+static atomic_uint morph_last_position = 0;
+
+/** @brief Serialises the control tasks. */
+static SemaphoreHandle_t morph_lock = NULL;
+
+/** @brief Storage for morph_lock. */
+static StaticSemaphore_t morph_lock_buf;
+
+/**
+ * @brief Publishes a new setup to the audio task; morph_lock must be held.
+ * @param config The setup.
+ */
+static void preset_morph_publish(const preset_morph_config_t *config)
+{
+    unsigned seq = atomic_load_explicit(&morph_seq, memory_order_relaxed);
+    atomic_store_explicit(&morph_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&morph_config, config, sizeof(morph_config));
+    atomic_store_explicit(&morph_seq, seq + 2, memory_order_release);
+}
+
+/**
+ * @brief Interpolates between two values.
+ * @param a Value at position 0.
+ * @param b Value at position 65535.
+ * @param position Morph position.
+ * @return int32_t The interpolated value.
+ */
+static int32_t morph_lerp(int32_t a, int32_t b, uint32_t position)
+{
+    return a + (int32_t)(((int64_t)(b - a) * position) / 65535);
+}
+
+/**
+ * @brief Computes the parameters at a morph position.
+ * @param config The morph setup.
+ * @param position Morph position.
+ * @param out Filled with the morphed parameters.
+ */
+static void preset_morph_mix(const preset_morph_config_t *config, uint32_t position, MenuParams_t *out)
+{
+    const MenuParams_t *a = &config->a;
+    const MenuParams_t *b = &config->b;
+    // Discrete fields come from the nearer preset
+    *out = position < 32768 ? *a : *b;
+    int32_t cents = morph_lerp(a->frequency_pitch * 100 + a->frequency_fine,
+                               b->frequency_pitch * 100 + b->frequency_fine, position);
+    // Whole notes within the MIDI range, the rest as fine tune within its ±100 cents
+    int32_t pitch = cents / 100;
+    if (pitch < 0)
+        pitch = 0;
+    else if (pitch > 127)
+        pitch = 127;
+    int32_t fine = cents - pitch * 100;
+    if (fine < -100)
+        fine = -100;
+    else if (fine > 100)
+        fine = 100;
+    out->frequency_pitch = pitch;
+    out->frequency_fine = fine;
+    out->level = morph_lerp(a->level, b->level, position);
+    out->pulse_width = morph_lerp(a->pulse_width, b->pulse_width, position);
+}
+
+/**
+ * @brief Creates the control-side lock. Call before any other task starts.
+ */
+void preset_morph_init(void)
+{
+    morph_lock = xSemaphoreCreateMutexStatic(&morph_lock_buf);
+}
+
+/**
+ * @brief Starts morphing between two presets, reading them from the preset bank once.
+ * @param slot_a Preset heard at position 0.
+ * @param slot_b Preset heard at position 65535.
+ * @param source TDM slot (0–15) driving the position, or PRESET_MORPH_SOURCE_POSITION.
+ * @return bool False if either slot holds no valid preset; the morph is left as it was.
+ */
+bool preset_morph_start(uint16_t slot_a, uint16_t slot_b, uint8_t source)
+{
+    preset_morph_config_t config = {
+        .running = true,
+        .source = source < TDM_SLOT_COUNT ? source : PRESET_MORPH_SOURCE_POSITION,
+    };
+    if (!preset_bank_get(slot_a, &config.a) || !preset_bank_get(slot_b, &config.b))
+        return false;
+    xSemaphoreTake(morph_lock, portMAX_DELAY);
+    preset_morph_publish(&config);
+    xSemaphoreGive(morph_lock);
+    return true;
+}
+
+/**
+ * @brief Stops morphing, keeping the sound by publishing the parameters last heard as the live parameters.
+ * @return bool True if a morph was running, false if there was nothing to stop.
+ */
+bool preset_morph_stop(void)
+{
+    xSemaphoreTake(morph_lock, portMAX_DELAY);
+    bool running = morph_config.running;
+    if (running)
+    {
+        preset_morph_config_t config = morph_config;
+        config.running = false;
+        // The events are stamped in the past so they apply at the start of the first block
+        // without the morph, and are queued before the stop is published so that block sees them
+        MenuParams_t *params = param_store_write_begin();
+        preset_morph_mix(&config, atomic_load_explicit(&morph_last_position, memory_order_relaxed), params);
+        param_store_write_end_at(audio_clock_now());
+        preset_morph_publish(&config);
+    }
+    xSemaphoreGive(morph_lock);
+    return running;
+}
+
+/**
+ * @brief Sets the morph position used when no TDM slot drives it.
+ * @param position 0 for preset A to 65535 for preset B.
+ */
+void preset_morph_set_position(uint16_t position)
+{
+    atomic_store_explicit(&morph_position, position, memory_order_relaxed);
+}
+
+/**
+ * @brief Computes the morphed parameters for one block. Audio task only; never blocks.
+ * @param mod Captured TDM block, or NULL if none has been captured (the last position is held).
+ * @param out Filled with the morphed parameters.
+ * @return bool True if a morph is running and out was filled.
+ */
+bool preset_morph_block(const tdm_block_t *mod, MenuParams_t *out)
+{
+    static preset_morph_config_t config;
+    static unsigned config_seq = 0;
+    unsigned seq = atomic_load_explicit(&morph_seq, memory_order_acquire);
+    if (seq != config_seq && !(seq & 1))
+    {
+        preset_morph_config_t copy;
+        memcpy(&copy, &morph_config, sizeof(copy));
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&morph_seq, memory_order_relaxed) == seq)
+        {
+            config = copy;
+            config_seq = seq;
+        }
+    }
+    if (!config.running)
+        return false;
+    uint32_t position;
+    if (config.source == PRESET_MORPH_SOURCE_POSITION)
+    {
+        position = atomic_load_explicit(&morph_position, memory_order_relaxed);
+    }
+    else if (mod)
+    {
+        // Block average of the bipolar slot signal, mapped to 0–65535
+        int32_t sum = 0;
+        for (int i = 0; i < TDM_RING_FRAMES; i++)
+            sum += mod->slots[config.source][i];
+        position = sum / TDM_RING_FRAMES + 32768;
+    }
+    else
+    {
+        // Nothing captured yet or the capture stalled: hold the last position rather than jump to the middle
+        position = atomic_load_explicit(&morph_last_position, memory_order_relaxed);
+    }
+    atomic_store_explicit(&morph_last_position, position, memory_order_relaxed);
+    preset_morph_mix(&config, position, out);
+    return true;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file preset_morph.h
+ * @brief Header file for the control-rate crossfade between two presets, driven by a position value or a TDM slot.
+ */
+
+#ifndef PRESET_MORPH_H
+#define PRESET_MORPH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_actions.h"
+#include "tdm_ring.h"
+
+/** @brief Morph source selecting the position set by preset_morph_set_position() instead of a TDM slot. */
+#define PRESET_MORPH_SOURCE_POSITION 0xFF
+
+/**
+ * @brief Creates the control-side lock. Call before any other task starts.
+ */
+void preset_morph_init(void);
+
+/**
+ * @brief Starts morphing between two presets, reading them from the preset bank once.
+ * @param slot_a Preset heard at position 0.
+ * @param slot_b Preset heard at position 65535.
+ * @param source TDM slot (0–15) driving the position, or PRESET_MORPH_SOURCE_POSITION.
+ * @return bool False if either slot holds no valid preset; the morph is left as it was.
+ */
+bool preset_morph_start(uint16_t slot_a, uint16_t slot_b, uint8_t source);
+
+/**
+ * @brief Stops morphing, keeping the sound by publishing the parameters last heard as the live parameters.
+ * @return bool True if a morph was running, false if there was nothing to stop.
+ */
+bool preset_morph_stop(void);
+
+/**
+ * @brief Sets the morph position used when no TDM slot drives it.
+ * @param position 0 for preset A to 65535 for preset B.
+ */
+void preset_morph_set_position(uint16_t position);
+
+/**
+ * @brief Computes the morphed parameters for one block. Audio task only; never blocks.
+ * @param mod Captured TDM block, or NULL if none has been captured (the last position is held).
+ * @param out Filled with the morphed parameters.
+ * @return bool True if a morph is running and out was filled.
+ */
+bool preset_morph_block(const tdm_block_t *mod, MenuParams_t *out);
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file settings_blob.c
+ * @brief Implementation of the versioned, CRC-protected NVS image of the parameters.
+ */
+
+#include "settings_blob.h"
+#include <string.h>
+#include "esp_rom_crc.h"
+#include "param_registry.h"
+
+/**
+ * @brief Computes the CRC of a blob's version, count and valid entries.
+ * @param blob The blob; count must not exceed SETTINGS_BLOB_MAX_ENTRIES.
+ * @return uint32_t The CRC-32.
+ */
+static uint32_t settings_blob_crc(const settings_blob_t *blob)
+{
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)blob, offsetof(settings_blob_t, crc));
+    return esp_rom_crc32_le(crc, (const uint8_t *)blob->entries, blob->count * sizeof(settings_blob_entry_t));
+}
+
+/**
+ * @brief Returns the number of bytes of a blob that are stored.
+ * @param blob The blob.
+ * @return size_t Header plus valid entries.
+ */
+size_t settings_blob_size(const settings_blob_t *blob)
+{
+    return offsetof(settings_blob_t, entries) + blob->count * sizeof(settings_blob_entry_t);
+}
+
+/**
+ * @brief Builds the image of a parameter set.
+ * @param params The parameters.
+ * @param blob Filled with the image, CRC included; entries past count are zeroed.
+ */
+void settings_blob_pack(const MenuParams_t *params, settings_blob_t *blob)
+{
+    _Static_assert(PARAM_FIELD_COUNT <= SETTINGS_BLOB_MAX_ENTRIES, "settings blob too small for the registry");
+    memset(blob, 0, sizeof(*blob));
+    blob->version = SETTINGS_BLOB_VERSION;
+    blob->count = PARAM_FIELD_COUNT;
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        blob->entries[field].id = param_registry[field].id;
+        blob->entries[field].value = param_get(params, field);
+    }
+    blob->crc = settings_blob_crc(blob);
+}
+
+/**
+ * @brief Recomputes the CRC of an image whose entries were changed in place.
+ * @param blob The image; count must not exceed SETTINGS_BLOB_MAX_ENTRIES.
+ */
+void settings_blob_seal(settings_blob_t *blob)
+{
+    blob->crc = settings_blob_crc(blob);
+}
+
+/**
+ * @brief Validates an image and applies it to a parameter set.
+ * @param blob The image as read from NVS.
+ * @param size Number of bytes read.
+ * @param params Updated with every entry whose ID is known; other fields are left as they are.
+ * @return bool True if the image was valid and applied.
+ */
+bool settings_blob_unpack(const settings_blob_t *blob, size_t size, MenuParams_t *params)
+{
+    if (size < offsetof(settings_blob_t, entries) || blob->version != SETTINGS_BLOB_VERSION ||
+        blob->count > SETTINGS_BLOB_MAX_ENTRIES || size != settings_blob_size(blob) ||
+        blob->crc != settings_blob_crc(blob))
+        return false;
+    for (int i = 0; i < blob->count; i++)
+    {
+        int field = param_registry_find(blob->entries[i].id);
+        if (field >= 0)
+            param_set(params, field, blob->entries[i].value);
+    }
+    return true;
+}
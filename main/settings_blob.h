@@ -0,0 +1,70 @@
+/**
+ * @file settings_blob.h
+ * @brief Header file for the versioned, CRC-protected image of the parameters saved to NVS as a single blob.
+ */
+
+#ifndef SETTINGS_BLOB_H
+#define SETTINGS_BLOB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "user_actions.h"
+
+/** @brief Layout version; bump when the header or entry layout changes, not when parameters are added. */
+#define SETTINGS_BLOB_VERSION 1
+
+/** @brief Most entries a blob can hold, leaving room for parameters added by later firmware. */
+#define SETTINGS_BLOB_MAX_ENTRIES 32
+
+/**
+ * @brief One saved parameter, keyed by its protocol ID so entries survive registry reordering.
+ */
+typedef struct
+{
+    uint16_t id;       ///< Parameter ID (ParamId_t)
+    uint16_t reserved; ///< Zero
+    int32_t value;     ///< Parameter value
+} settings_blob_entry_t;
+
+/**
+ * @brief Saved image; only the first count entries are stored.
+ */
+typedef struct
+{
+    uint16_t version;                                         ///< SETTINGS_BLOB_VERSION
+    uint16_t count;                                           ///< Number of valid entries
+    uint32_t crc;                                             ///< CRC-32 of version, count and the valid entries
+    settings_blob_entry_t entries[SETTINGS_BLOB_MAX_ENTRIES]; ///< Saved parameters
+} settings_blob_t;
+
+/**
+ * @brief Returns the number of bytes of a blob that are stored.
+ * @param blob The blob.
+ * @return size_t Header plus valid entries.
+ */
+size_t settings_blob_size(const settings_blob_t *blob);
+
+/**
+ * @brief Builds the image of a parameter set.
+ * @param params The parameters.
+ * @param blob Filled with the image, CRC included; entries past count are zeroed.
+ */
+void settings_blob_pack(const MenuParams_t *params, settings_blob_t *blob);
+
+/**
+ * @brief Recomputes the CRC of an image whose entries were changed in place.
+ * @param blob The image; count must not exceed SETTINGS_BLOB_MAX_ENTRIES.
+ */
+void settings_blob_seal(settings_blob_t *blob);
+
+/**
+ * @brief Validates an image and applies it to a parameter set.
+ * @param blob The image as read from NVS.
+ * @param size Number of bytes read.
+ * @param params Updated with every entry whose ID is known; other fields are left as they are.
+ * @return bool True if the image was valid and applied.
+ */
+bool settings_blob_unpack(const settings_blob_t *blob, size_t size, MenuParams_t *params);
+
+#endif
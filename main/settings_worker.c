@@ -0,0 +1,203 @@
+/**
+ * @file settings_worker.c
+ * @brief Implementation of the low-priority settings worker.
+ *
+ * Control paths (I2C commands, menu actions) only update the parameter store and post flags
+ * to this task through its notification value, which merges repeated requests for free. The
+ * worker then redraws the display at most once per SETTINGS_DISPLAY_INTERVAL_MS and writes
+ * NVS once the parameters have stopped changing, so a burst of commands costs one flash
+ * commit and a handful of redraws instead of one of each per message. Preset stores and
+ * clears are queued (stores with their parameters) and applied to the preset bank here as
+ * well, so this task is the bank's only writer.
+ */
+
+#include "settings_worker.h"
+#include <stdbool.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_lvgl_port.h"
+#include "Esp_menu.h"
+#include "user_actions.h"
+#include "param_store.h"
+#include "param_group.h"
+#include "preset_bank.h"
+
+/** @brief Parameters must be unchanged this long before a SETTINGS_WORK_SAVE is written to NVS. */
+#define SETTINGS_SAVE_QUIET_MS CONFIG_OSC_NVS_SAVE_QUIET_MS
+
+/** @brief Minimum time between two display refreshes. */
+#define SETTINGS_DISPLAY_INTERVAL_MS 50
+
+/** @brief Worker task priority, below the audio and I2C tasks. */
+#define SETTINGS_WORKER_PRIORITY 2
+
+/** @brief Worker task stack size (bytes). */
+#define SETTINGS_WORKER_STACK 4096
+
+/** @brief Internal work flag: preset requests are queued. */
+#define SETTINGS_WORK_PRESET (1u << 31)
+
+/** @brief Number of preset requests that can wait for the worker. */
+#define SETTINGS_PRESET_QUEUE_LEN 4
+
+/**
+ * @brief Preset request; a store carries the parameters as they were when it was made.
+ */
+typedef struct
+{
+    uint16_t slot;              ///< Destination slot
+    bool clear;                 ///< Erase the slot instead of storing
+    char name[PRESET_NAME_LEN]; ///< Preset name
+    MenuParams_t params;        ///< Parameters to store
+} settings_preset_req_t;
+
+/** @brief Pending preset requests, applied in order. */
+static QueueHandle_t settings_preset_queue = NULL;
+
+/** @brief Worker task handle. */
+static TaskHandle_t settings_worker_task = NULL;
+
+/** @brief Set once LVGL is initialized and the display may be touched. */
+static volatile bool settings_display_ready = false;
+
+/**
+ * @brief Returns the ticks left until an interval that started at a given tick has elapsed.
+ * @param since Tick the interval started at.
+ * @param interval Interval length in ticks.
+ * @return TickType_t Ticks to wait, 0 if the interval is over.
+ */
+static TickType_t settings_ticks_left(TickType_t since, TickType_t interval)
+{
+    TickType_t elapsed = xTaskGetTickCount() - since;
+    return elapsed < interval ? interval - elapsed : 0;
+}
+
+/**
+ * @brief Worker task body.
+ *
+ * The notification wait doubles as the timer for both the NVS quiet time and the display
+ * interval, so a redraw that is held back never delays a save or a preset request.
+ * @param arg Unused task argument.
+ */
+static void settings_worker(void *arg)
+{
+    uint32_t pending = 0;
+    TickType_t last_change = 0;
+    // Far enough in the past that the first redraw is not held back
+    TickType_t last_redraw = xTaskGetTickCount() - pdMS_TO_TICKS(SETTINGS_DISPLAY_INTERVAL_MS);
+    while (1)
+    {
+        TickType_t wait = portMAX_DELAY;
+        if (pending & SETTINGS_WORK_SAVE)
+            wait = settings_ticks_left(last_change, pdMS_TO_TICKS(SETTINGS_SAVE_QUIET_MS));
+        if ((pending & SETTINGS_WORK_DISPLAY) && settings_display_ready)
+        {
+            TickType_t display_wait = settings_ticks_left(last_redraw, pdMS_TO_TICKS(SETTINGS_DISPLAY_INTERVAL_MS));
+            wait = display_wait < wait ? display_wait : wait;
+        }
+        uint32_t flags = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &flags, wait);
+        if (flags & SETTINGS_WORK_GROUP)
+        {
+            // Published here rather than at commit time, once the audio task has applied them
+            param_group_publish_applied();
+            flags = (flags & ~SETTINGS_WORK_GROUP) | SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY;
+        }
+        if (flags & SETTINGS_WORK_SAVE)
+            last_change = xTaskGetTickCount();
+        pending |= flags;
+
+        // Requests arriving within the interval stay pending and share the next redraw
+        if ((pending & SETTINGS_WORK_DISPLAY) && settings_display_ready &&
+            settings_ticks_left(last_redraw, pdMS_TO_TICKS(SETTINGS_DISPLAY_INTERVAL_MS)) == 0)
+        {
+            pending &= ~SETTINGS_WORK_DISPLAY;
+            last_redraw = xTaskGetTickCount();
+            if (lvgl_port_lock(0))
+            {
+                user_update_display();
+                lvgl_port_unlock();
+            }
+        }
+        if ((pending & SETTINGS_WORK_SAVE_NOW) ||
+            ((pending & SETTINGS_WORK_SAVE) && xTaskGetTickCount() - last_change >= pdMS_TO_TICKS(SETTINGS_SAVE_QUIET_MS)))
+        {
+            pending &= ~(SETTINGS_WORK_SAVE | SETTINGS_WORK_SAVE_NOW);
+            save_to_nvs();
+        }
+        if (pending & SETTINGS_WORK_PRESET)
+        {
+            pending &= ~SETTINGS_WORK_PRESET;
+            settings_preset_req_t req;
+            while (xQueueReceive(settings_preset_queue, &req, 0) == pdTRUE)
+            {
+                if (req.clear)
+                    preset_bank_clear(req.slot);
+                else
+                    preset_bank_store(req.slot, req.name, &req.params);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Starts the worker task. Call before any task posts work.
+ */
+void settings_worker_start(void)
+{
+    settings_preset_queue = xQueueCreate(SETTINGS_PRESET_QUEUE_LEN, sizeof(settings_preset_req_t));
+    xTaskCreate(settings_worker, "settings_worker", SETTINGS_WORKER_STACK, NULL, SETTINGS_WORKER_PRIORITY,
+                &settings_worker_task);
+}
+
+/**
+ * @brief Requests deferred work without blocking; repeated requests are merged.
+ * @param flags Combination of SETTINGS_WORK_* flags.
+ */
+void settings_worker_post(uint32_t flags)
+{
+    xTaskNotify(settings_worker_task, flags, eSetBits);
+}
+
+/**
+ * @brief Allows display refreshes once LVGL is running, and performs any that were held back.
+ */
+void settings_worker_enable_display(void)
+{
+    settings_display_ready = true;
+    settings_worker_post(SETTINGS_WORK_DISPLAY);
+}
+
+/**
+ * @brief Stores the live parameters as a preset from the worker, without blocking on flash.
+ * @param slot Destination slot.
+ * @param name Preset name, truncated to PRESET_NAME_LEN - 1 characters.
+ * @return bool False if too many preset requests are already waiting.
+ */
+bool settings_worker_store_preset(uint16_t slot, const char *name)
+{
+    settings_preset_req_t req = {.slot = slot};
+    strncpy(req.name, name, PRESET_NAME_LEN - 1);
+    param_store_get(&req.params);
+    if (xQueueSend(settings_preset_queue, &req, 0) != pdTRUE)
+        return false;
+    settings_worker_post(SETTINGS_WORK_PRESET);
+    return true;
+}
+
+/**
+ * @brief Erases a preset from the worker, without blocking on flash.
+ * @param slot The slot to erase.
+ * @return bool False if too many preset requests are already waiting.
+ */
+bool settings_worker_clear_preset(uint16_t slot)
+{
+    settings_preset_req_t req = {.slot = slot, .clear = true};
+    if (xQueueSend(settings_preset_queue, &req, 0) != pdTRUE)
+        return false;
+    settings_worker_post(SETTINGS_WORK_PRESET);
+    return true;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file settings_worker.h
+ * @brief Header file for the low-priority worker that coalesces NVS saves and display refreshes requested by the control paths.
+ */
+
+#ifndef SETTINGS_WORKER_H
+#define SETTINGS_WORKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** @brief Work flag: refresh the parameter display. */
+#define SETTINGS_WORK_DISPLAY (1u << 0)
+
+/** @brief Work flag: save the parameters once they have been quiet for SETTINGS_SAVE_QUIET_MS. */
+#define SETTINGS_WORK_SAVE (1u << 1)
+
+/** @brief Work flag: save the parameters as soon as possible. */
+#define SETTINGS_WORK_SAVE_NOW (1u << 2)
+
+/** @brief Work flag: publish the parameter groups the audio task has applied, then save and redraw. */
+#define SETTINGS_WORK_GROUP (1u << 3)
+
+/**
+ * @brief Starts the worker task. Call before any task posts work.
+ */
+void settings_worker_start(void);
+
+/**
+ * @brief Requests deferred work without blocking; repeated requests are merged.
+ * @param flags Combination of SETTINGS_WORK_* flags.
+ */
+void settings_worker_post(uint32_t flags);
+
+/**
+ * @brief Allows display refreshes once LVGL is running, and performs any that were held back.
+ */
+void settings_worker_enable_display(void);
+
+/**
+ * @brief Stores the live parameters as a preset from the worker, without blocking on flash.
+ * @param slot Destination slot.
+ * @param name Preset name, truncated to PRESET_NAME_LEN - 1 characters.
+ * @return bool False if too many preset requests are already waiting.
+ */
+bool settings_worker_store_preset(uint16_t slot, const char *name);
+
+/**
+ * @brief Erases a preset from the worker, without blocking on flash.
+ * @param slot The slot to erase.
+ * @return bool False if too many preset requests are already waiting.
+ */
+bool settings_worker_clear_preset(uint16_t slot);
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file tdm_ring.c
+ * @brief Implementation of the lock-free SPSC ring carrying captured TDM blocks to the audio task.
+ *
+ * head counts published blocks and is written only by the producer; tail indexes the block the
+ * consumer currently holds and is written only by the consumer. Both are free-running counters,
+ * so head - tail is the number of blocks not yet released and the ring is full when it reaches
+ * TDM_RING_BLOCKS. Acquire/release ordering makes the block contents visible before the counter.
+ */
+
+#include "tdm_ring.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+/** @brief Ring storage. */
+static tdm_block_t ring_blocks[TDM_RING_BLOCKS];
+
+/** @brief Number of blocks published by the producer. */
+static atomic_uint ring_head = 0;
+
+/** @brief Index of the block held by the consumer. */
+static atomic_uint ring_tail = 0;
+
+/**
+ * @brief Returns the next block for the producer to fill.
+ * @return tdm_block_t* Block to fill, or NULL if the consumer still holds every other block.
+ */
+tdm_block_t *tdm_ring_acquire(void)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    if (head - tail >= TDM_RING_BLOCKS)
+        return NULL;
+    return &ring_blocks[head % TDM_RING_BLOCKS];
+}
+
+/**
+ * @brief Publishes the block returned by tdm_ring_acquire() to the consumer.
+ */
+void tdm_ring_publish(void)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+}
+
+/**
+ * @brief Returns the newest published block for the consumer.
+ * @return const tdm_block_t* Newest block, or NULL if nothing has been captured yet.
+ */
+const tdm_block_t *tdm_ring_latest(void)
+{
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    if (head == 0)
+        return NULL;
+    if (head - tail >= 2)
+    {
+        tail = head - 1;
+        atomic_store_explicit(&ring_tail, tail, memory_order_release);
+    }
+    return &ring_blocks[tail % TDM_RING_BLOCKS];
+}
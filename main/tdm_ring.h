@@ -0,0 +1,50 @@
+/**
+ * @file tdm_ring.h
+ * @brief Header file for the lock-free single-producer/single-consumer ring carrying captured TDM blocks to the audio task.
+ */
+
+#ifndef TDM_RING_H
+#define TDM_RING_H
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+/** @brief Number of slots in a backplane TDM frame. */
+#define TDM_SLOT_COUNT 16
+
+/** @brief Frames per captured block; matches the audio render block size. */
+#define TDM_RING_FRAMES CONFIG_OSC_I2S_DMA_FRAME_NUM
+
+/** @brief Number of blocks in the ring. */
+#define TDM_RING_BLOCKS 4
+
+/**
+ * @brief One block of captured TDM audio, de-interleaved by slot.
+ */
+typedef struct
+{
+    int16_t slots[TDM_SLOT_COUNT][TDM_RING_FRAMES]; ///< Samples per slot, in frame order
+} tdm_block_t;
+
+/**
+ * @brief Returns the next block for the producer to fill.
+ * @return tdm_block_t* Block to fill, or NULL if the consumer still holds every other block.
+ */
+tdm_block_t *tdm_ring_acquire(void);
+
+/**
+ * @brief Publishes the block returned by tdm_ring_acquire() to the consumer.
+ */
+void tdm_ring_publish(void);
+
+/**
+ * @brief Returns the newest published block for the consumer.
+ * @return const tdm_block_t* Newest block, or NULL if nothing has been captured yet.
+ *
+ * Older blocks, including the one returned by the previous call, are released to the
+ * producer. If nothing new arrived the previous block is returned again, so modulation
+ * holds its last value instead of dropping to zero.
+ */
+const tdm_block_t *tdm_ring_latest(void);
+
+#endif
@@ -4,6 +4,12 @@
  */
 
 #include "user_actions.h"
+#include "param_registry.h"
+#include "param_store.h"
+#include "settings_worker.h"
+#include "settings_blob.h"
+#include "warm_cache.h"
+#include "preset_bank.h"
 #include "Esp_menu.h"
 #include "module_i2c_proto.h"
 #ifdef CONFIG_ESPMENU_ENABLE_NVS
@@ -12,28 +18,12 @@
 #include <string.h>
 #include "lvgl.h"
 
-/** @brief Number of favorite slots for parameter storage. */
-#define NUM_FAVORITE_SLOTS 4
-
-/** @brief Global oscillator parameters. */
-MenuParams_t menu_params = {69, 0, OSC_WAVE_SINE, 65535, 32768, 0xFF, 0xFF, 0xFF};
-
-/** @brief Current favorite slot index (0–3). */
-static uint8_t current_slot = 0;
+/** @brief Preset bank slot selected in the favorites menu. */
+static uint16_t current_slot = 0;
 
 /** @brief LVGL label for displaying parameters. */
 static lv_obj_t *param_label = NULL;
 
-/**
- * @brief Initializes project-specific state, including loading from NVS if enabled.
- */
-void user_init(void)
-{
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    load_from_nvs();
-#endif
-}
-
 /**
  * @brief Updates the LVGL display with current parameters (pitch and waveform).
  */
@@ -44,113 +34,161 @@ void user_update_display(void)
         param_label = lv_label_create(lv_scr_act());
         lv_obj_set_pos(param_label, 0, 0);
     }
+    MenuParams_t params;
+    param_store_get(&params);
     char buf[32];
     const char *wave_names[] = {"Sine", "Triangle", "Saw", "Square", "Pulse"};
-    snprintf(buf, sizeof(buf), "P:%d W:%s", menu_params.frequency_pitch, wave_names[menu_params.waveform]);
+    snprintf(buf, sizeof(buf), "P:%d W:%s", params.frequency_pitch, wave_names[params.waveform]);
     lv_label_set_text(param_label, buf);
 }
 
 #ifdef CONFIG_ESPMENU_ENABLE_NVS
+/** @brief NVS key of the settings blob. */
+#define SETTINGS_BLOB_KEY "settings"
+
+/** @brief Image last written to or read from NVS; count is 0 until one exists. */
+static settings_blob_t saved_blob;
+
+/** @brief Set when the parameters were loaded from the per-parameter keys of older firmware. */
+static bool legacy_keys_present = false;
+
 /**
  * @brief Saves current parameters to Non-Volatile Storage (NVS).
+ *
+ * The whole state is written as one versioned, CRC-protected blob. Nothing is written when
+ * the image matches the one already in flash, so repeated saves of unchanged parameters
+ * cost no flash wear. The per-parameter keys of older firmware are erased on the first save.
  */
 void save_to_nvs(void)
 {
+    MenuParams_t params;
+    param_store_get(&params);
+    settings_blob_t blob;
+    settings_blob_pack(&params, &blob);
+    if (memcmp(&blob, &saved_blob, sizeof(blob)) == 0)
+        return;
     nvs_handle_t nvs;
     esp_err_t err = nvs_open("oscillator", NVS_READWRITE, &nvs);
     if (err != ESP_OK)
         return;
-    nvs_set_u8(nvs, "freq_pitch", menu_params.frequency_pitch);
-    nvs_set_i16(nvs, "freq_fine", menu_params.frequency_fine);
-    nvs_set_u8(nvs, "waveform", menu_params.waveform);
-    nvs_set_u16(nvs, "level", menu_params.level);
-    nvs_set_u16(nvs, "pulse_width", menu_params.pulse_width);
-    nvs_set_u8(nvs, "amp_mod_slot", menu_params.amp_mod_slot);
-    nvs_set_u8(nvs, "freq_mod_slot", menu_params.freq_mod_slot);
-    nvs_set_u8(nvs, "sync_slot", menu_params.sync_source_slot);
-    nvs_commit(nvs);
+    err = nvs_set_blob(nvs, SETTINGS_BLOB_KEY, &blob, settings_blob_size(&blob));
+    if (err == ESP_OK && legacy_keys_present)
+    {
+        for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+            nvs_erase_key(nvs, param_registry[field].nvs_key);
+    }
+    if (err == ESP_OK)
+        err = nvs_commit(nvs);
     nvs_close(nvs);
+    if (err == ESP_OK)
+    {
+        saved_blob = blob;
+        legacy_keys_present = false;
+    }
 }
 
 /**
- * @brief Loads parameters from Non-Volatile Storage (NVS) and updates the display.
+ * @brief Reads the per-parameter keys written by older firmware.
+ * @param nvs Open NVS handle.
+ * @param params Updated with every key found.
+ * @return bool True if any key was found.
  */
-void load_from_nvs(void)
+static bool load_legacy_keys(nvs_handle_t nvs, MenuParams_t *params)
 {
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open("oscillator", NVS_READONLY, &nvs);
-    if (err != ESP_OK)
-        return;
-    nvs_get_u8(nvs, "freq_pitch", &menu_params.frequency_pitch);
-    nvs_get_i16(nvs, "freq_fine", &menu_params.frequency_fine);
-    nvs_get_u8(nvs, "waveform", (uint8_t *)&menu_params.waveform);
-    nvs_get_u16(nvs, "level", &menu_params.level);
-    nvs_get_u16(nvs, "pulse_width", &menu_params.pulse_width);
-    nvs_get_u8(nvs, "amp_mod_slot", &menu_params.amp_mod_slot);
-    nvs_get_u8(nvs, "freq_mod_slot", &menu_params.freq_mod_slot);
-    nvs_get_u8(nvs, "sync_slot", &menu_params.sync_source_slot);
-    nvs_close(nvs);
-    user_update_display();
+    bool found = false;
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        const param_desc_t *desc = &param_registry[field];
+        esp_err_t err;
+        switch (desc->type)
+        {
+        case PARAM_TYPE_S16:
+        {
+            int16_t value;
+            if ((err = nvs_get_i16(nvs, desc->nvs_key, &value)) == ESP_OK)
+                param_set(params, field, value);
+            break;
+        }
+        case PARAM_TYPE_U16:
+        {
+            uint16_t value;
+            if ((err = nvs_get_u16(nvs, desc->nvs_key, &value)) == ESP_OK)
+                param_set(params, field, value);
+            break;
+        }
+        default:
+        {
+            uint8_t value;
+            if ((err = nvs_get_u8(nvs, desc->nvs_key, &value)) == ESP_OK)
+                param_set(params, field, value);
+            break;
+        }
+        }
+        found |= err == ESP_OK;
+    }
+    return found;
 }
 
 /**
- * @brief Saves parameters to a favorite slot in NVS.
- * @param slot The favorite slot index (0–3).
+ * @brief Reads the stored parameters and records what was found for save_to_nvs().
+ * @param nvs Open NVS handle.
+ * @param params Updated with the stored values.
+ *
+ * A blob that is missing, from another layout version or fails its CRC is ignored, and the
+ * per-parameter keys of older firmware are tried instead.
  */
-void save_favorite(uint8_t slot)
+static void read_saved_state(nvs_handle_t nvs, MenuParams_t *params)
 {
-    if (slot >= NUM_FAVORITE_SLOTS)
-        return;
-    nvs_handle_t nvs;
-    esp_err_t err = nvs_open("oscillator", NVS_READWRITE, &nvs);
-    if (err != ESP_OK)
-        return;
-    char key[16];
-    snprintf(key, sizeof(key), "fav_slot_%d", slot);
-    nvs_set_blob(nvs, key, &menu_params, sizeof(MenuParams_t));
-    nvs_commit(nvs);
-    nvs_close(nvs);
+    settings_blob_t blob;
+    size_t size = sizeof(blob);
+    if (nvs_get_blob(nvs, SETTINGS_BLOB_KEY, &blob, &size) == ESP_OK && settings_blob_unpack(&blob, size, params))
+    {
+        // Zero the unread tail so the image compares equal to a fresh pack of the same values
+        memset((uint8_t *)&blob + size, 0, sizeof(blob) - size);
+        saved_blob = blob;
+    }
+    else
+    {
+        legacy_keys_present = load_legacy_keys(nvs, params);
+    }
 }
 
 /**
- * @brief Loads parameters from a favorite slot in NVS and updates the display.
- * @param slot The favorite slot index (0–3).
+ * @brief Records what NVS holds without changing the live parameters, after a warm restart.
+ *
+ * Lets save_to_nvs() skip writing an image that is already in flash and erase the keys of
+ * older firmware, as it does after a cold boot.
  */
-void load_favorite(uint8_t slot)
+static void seed_saved_state(void)
 {
-    if (slot >= NUM_FAVORITE_SLOTS)
-        return;
     nvs_handle_t nvs;
-    esp_err_t err = nvs_open("oscillator", NVS_READONLY, &nvs);
-    if (err != ESP_OK)
+    if (nvs_open("oscillator", NVS_READONLY, &nvs) != ESP_OK)
         return;
-    char key[16];
-    snprintf(key, sizeof(key), "fav_slot_%d", slot);
-    size_t size = sizeof(MenuParams_t);
-    nvs_get_blob(nvs, key, &menu_params, &size);
+    MenuParams_t scratch;
+    param_set_defaults(&scratch);
+    read_saved_state(nvs, &scratch);
     nvs_close(nvs);
-    save_to_nvs();
-    user_update_display();
 }
 
 /**
- * @brief Clears a favorite slot in NVS.
- * @param slot The favorite slot index (0–3).
+ * @brief Loads parameters from Non-Volatile Storage (NVS) and updates the display.
+ *
+ * A blob that is missing, from another layout version or fails its CRC is ignored, and the
+ * per-parameter keys of older firmware are tried instead.
  */
-void clear_favorite(uint8_t slot)
+void load_from_nvs(void)
 {
-    if (slot >= NUM_FAVORITE_SLOTS)
-        return;
     nvs_handle_t nvs;
-    esp_err_t err = nvs_open("oscillator", NVS_READWRITE, &nvs);
+    esp_err_t err = nvs_open("oscillator", NVS_READONLY, &nvs);
     if (err != ESP_OK)
         return;
-    char key[16];
-    snprintf(key, sizeof(key), "fav_slot_%d", slot);
-    nvs_erase_key(nvs, key);
-    nvs_commit(nvs);
+    MenuParams_t *params = param_store_write_begin();
+    read_saved_state(nvs, params);
+    param_store_write_end();
     nvs_close(nvs);
+    settings_worker_post(SETTINGS_WORK_DISPLAY);
 }
+
 #else
 /**
  * @brief Stub for saving to NVS when NVS is disabled.
@@ -161,84 +199,70 @@ void save_to_nvs(void) {}
  * @brief Stub for loading from NVS when NVS is disabled.
  */
 void load_from_nvs(void) {}
+#endif
 
 /**
- * @brief Stub for saving to a favorite slot when NVS is disabled.
- * @param slot The favorite slot index (0–3).
- */
-void save_favorite(uint8_t slot) {}
-
-/**
- * @brief Stub for loading from a favorite slot when NVS is disabled.
- * @param slot The favorite slot index (0–3).
+ * @brief Initializes project-specific state, including loading from NVS if enabled.
  */
-void load_favorite(uint8_t slot) {}
+void user_init(void)
+{
+    preset_bank_init();
+#ifdef CONFIG_ESPMENU_ENABLE_NVS
+    if (warm_cache_restored())
+    {
+        // The exact pre-reset state is already live; only learn what flash holds, and save if it lags behind
+        seed_saved_state();
+        settings_worker_post(SETTINGS_WORK_SAVE);
+    }
+    else
+    {
+        load_from_nvs();
+    }
+#endif
+}
 
 /**
- * @brief Stub for clearing a favorite slot when NVS is disabled.
- * @param slot The favorite slot index (0–3).
+ * @brief Steps a parameter from a menu action, schedules it for saving and updates the display.
+ * @param field The parameter to step.
+ * @param dir +1 to step up, -1 to step down.
  */
-void clear_favorite(uint8_t slot) {}
-#endif
+static void user_param_step(param_field_t field, int dir)
+{
+    param_step(param_store_write_begin(), field, dir);
+    param_store_write_end();
+    settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
+}
 
 /**
- * @brief Increments the frequency pitch and updates the display.
+ * @brief Increments the frequency pitch.
  */
 void pitch_up(void)
 {
-    menu_params.frequency_pitch = menu_params.frequency_pitch < 127 ? menu_params.frequency_pitch + 1 : 127;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
-    user_update_display();
+    user_param_step(PARAM_FIELD_PITCH, 1);
 }
 
 /**
- * @brief Decrements the frequency pitch and updates the display.
+ * @brief Decrements the frequency pitch.
  */
 void pitch_down(void)
 {
-    menu_params.frequency_pitch = menu_params.frequency_pitch > 0 ? menu_params.frequency_pitch - 1 : 0;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
-    user_update_display();
+    user_param_step(PARAM_FIELD_PITCH, -1);
 }
 
 /**
- * @brief Selects the next waveform type and updates the display.
+ * @brief Selects the next waveform type.
  */
 void waveform_next(void)
 {
-    menu_params.waveform = (menu_params.waveform + 1) % 5;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
-    user_update_display();
+    user_param_step(PARAM_FIELD_WAVEFORM, 1);
 }
 
 /**
- * @brief Selects the previous waveform type and updates the display.
+ * @brief Selects the previous waveform type.
  */
 void waveform_prev(void)
 {
-    menu_params.waveform = (menu_params.waveform + 4) % 5;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
-    user_update_display();
+    user_param_step(PARAM_FIELD_WAVEFORM, -1);
 }
 
 /**
@@ -246,13 +270,7 @@ void waveform_prev(void)
  */
 void level_up(void)
 {
-    menu_params.level = menu_params.level < 65535 - 655 ? menu_params.level + 655 : 65535;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_LEVEL, 1);
 }
 
 /**
@@ -260,13 +278,7 @@ void level_up(void)
  */
 void level_down(void)
 {
-    menu_params.level = menu_params.level > 655 ? menu_params.level - 655 : 0;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_LEVEL, -1);
 }
 
 /**
@@ -274,13 +286,7 @@ void level_down(void)
  */
 void fine_tune_up(void)
 {
-    menu_params.frequency_fine = menu_params.frequency_fine < 100 ? menu_params.frequency_fine + 1 : 100;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_FINE, 1);
 }
 
 /**
@@ -288,13 +294,7 @@ void fine_tune_up(void)
  */
 void fine_tune_down(void)
 {
-    menu_params.frequency_fine = menu_params.frequency_fine > -100 ? menu_params.frequency_fine - 1 : -100;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_FINE, -1);
 }
 
 /**
@@ -302,13 +302,7 @@ void fine_tune_down(void)
  */
 void pulse_width_up(void)
 {
-    menu_params.pulse_width = menu_params.pulse_width < 65535 - 655 ? menu_params.pulse_width + 655 : 65535;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_PW, 1);
 }
 
 /**
@@ -316,13 +310,7 @@ void pulse_width_up(void)
  */
 void pulse_width_down(void)
 {
-    menu_params.pulse_width = menu_params.pulse_width > 655 ? menu_params.pulse_width - 655 : 0;
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_PW, -1);
 }
 
 /**
@@ -330,13 +318,7 @@ void pulse_width_down(void)
  */
 void amp_mod_slot_next(void)
 {
-    menu_params.amp_mod_slot = menu_params.amp_mod_slot == 0xFF ? 0 : (menu_params.amp_mod_slot < 15 ? menu_params.amp_mod_slot + 1 : 0xFF);
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_AMP_MOD_SLOT, 1);
 }
 
 /**
@@ -344,13 +326,7 @@ void amp_mod_slot_next(void)
  */
 void amp_mod_slot_prev(void)
 {
-    menu_params.amp_mod_slot = menu_params.amp_mod_slot == 0xFF ? 15 : (menu_params.amp_mod_slot > 0 ? menu_params.amp_mod_slot - 1 : 0xFF);
-#ifdef CONFIG_ESPMENU_ENABLE_NVS
-    extern bool param_changed;
-    extern TickType_t last_param_change;
-    param_changed = true;
-    last_param_change = xTaskGetTickCount();
-#endif
+    user_param_step(PARAM_FIELD_AMP_MOD_SLOT, -1);
 }
 
 /**
@@ -358,7 +334,7 @@ void amp_mod_slot_prev(void)
  */
 void select_favorite_slot_next(void)
 {
-    current_slot = (current_slot + 1) % NUM_FAVORITE_SLOTS;
+    current_slot = (current_slot + 1) % PRESET_BANK_SLOTS;
 }
 
 /**
@@ -366,7 +342,7 @@ void select_favorite_slot_next(void)
  */
 void select_favorite_slot_prev(void)
 {
-    current_slot = (current_slot + NUM_FAVORITE_SLOTS - 1) % NUM_FAVORITE_SLOTS;
+    current_slot = (current_slot + PRESET_BANK_SLOTS - 1) % PRESET_BANK_SLOTS;
 }
 
 /**
@@ -374,7 +350,9 @@ void select_favorite_slot_prev(void)
  */
 void save_favorite_action(void)
 {
-    save_favorite(current_slot);
+    char name[PRESET_NAME_LEN];
+    snprintf(name, sizeof(name), "Preset %u", current_slot + 1);
+    settings_worker_store_preset(current_slot, name);
 }
 
 /**
@@ -382,7 +360,8 @@ void save_favorite_action(void)
  */
 void load_favorite_action(void)
 {
-    load_favorite(current_slot);
+    if (preset_bank_recall(current_slot))
+        settings_worker_post(SETTINGS_WORK_SAVE | SETTINGS_WORK_DISPLAY);
 }
 
 /**
@@ -390,5 +369,5 @@ void load_favorite_action(void)
  */
 void clear_favorite_action(void)
 {
-    clear_favorite(current_slot);
+    settings_worker_clear_preset(current_slot);
 }
\ No newline at end of file
@@ -24,9 +24,6 @@ typedef struct
     uint8_t sync_source_slot; ///< Sync source slot (0–15 or 0xFF)
 } MenuParams_t;
 
-/** @brief Global oscillator parameters. */
-extern MenuParams_t menu_params;
-
 /**
  * @brief Initializes project-specific state, including loading from NVS if enabled.
  */
@@ -0,0 +1,116 @@
+/**
+ * @file warm_cache.c
+ * @brief Implementation of the RTC-memory mirror of the live parameters.
+ *
+ * The mirror uses the same versioned, CRC-protected image as the NVS blob. RTC_NOINIT memory
+ * keeps its contents over software resets, panics and watchdog resets but holds garbage after
+ * power-on, so the image is trusted only for those reset reasons and only if its CRC matches.
+ * The project places RTC_NOINIT data in RTC fast memory (CONFIG_ESP32S3_RTCDATA_IN_FAST_MEM),
+ * which the CPU reads and writes at internal SRAM speed instead of over the slow RTC bus.
+ *
+ * A publish only rewrites the entries whose value changed, under the parameter store's writer
+ * lock. The CRC is left to warm_cache_seal(), which the audio task runs once per block when
+ * something changed. A reset between the two finds a stale CRC, rejects the image and falls
+ * back to NVS, as after a power-on.
+ */
+
+#include "warm_cache.h"
+#include <stdatomic.h>
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "sdkconfig.h"
+#include "param_registry.h"
+#include "settings_blob.h"
+
+#if CONFIG_IDF_TARGET_ESP32S3 && !CONFIG_ESP32S3_RTCDATA_IN_FAST_MEM
+#warning "warm_cache expects CONFIG_ESP32S3_RTCDATA_IN_FAST_MEM, or the mirror lives in slow RTC memory"
+#endif
+
+/** @brief Mirror of the live parameters, surviving warm restarts. */
+static RTC_NOINIT_ATTR settings_blob_t warm_blob;
+
+/** @brief Set when this boot restored the mirror. */
+static bool warm_restored = false;
+
+/** @brief Set once this boot has packed the whole mirror; until then it may hold another layout or garbage. */
+static bool warm_packed = false;
+
+/** @brief Set by a publish that changed an entry, cleared by the warm_cache_seal() that recomputes the CRC. */
+static atomic_bool warm_dirty = false;
+
+/**
+ * @brief Mirrors the parameters into RTC memory. Called by the parameter store on every publish.
+ * @param params The parameters just published.
+ *
+ * The first call packs the whole image; later ones only rewrite the changed entries.
+ */
+void warm_cache_store(const MenuParams_t *params)
+{
+    if (!warm_packed)
+    {
+        settings_blob_pack(params, &warm_blob);
+        warm_packed = true;
+        return;
+    }
+    bool changed = false;
+    for (int field = 0; field < PARAM_FIELD_COUNT; field++)
+    {
+        int32_t value = param_get(params, field);
+        if (warm_blob.entries[field].value != value)
+        {
+            warm_blob.entries[field].value = value;
+            changed = true;
+        }
+    }
+    // Raised after the entries, so a seal already running recomputes once more on the next block
+    if (changed)
+        atomic_store_explicit(&warm_dirty, true, memory_order_release);
+}
+
+/**
+ * @brief Recomputes the mirror's CRC if a publish changed it. Audio task only, once per block.
+ *
+ * Never blocks: a publish overlapping the computation raises the flag again, so the CRC is
+ * redone on the next block.
+ */
+void warm_cache_seal(void)
+{
+    if (atomic_exchange_explicit(&warm_dirty, false, memory_order_acquire))
+        settings_blob_seal(&warm_blob);
+}
+
+/**
+ * @brief Restores the mirrored parameters after a warm restart.
+ * @param params Updated with the mirrored parameters if they are valid.
+ * @return bool True if the chip was reset without losing RTC memory and the mirror passed its checks.
+ */
+bool warm_cache_load(MenuParams_t *params)
+{
+    switch (esp_reset_reason())
+    {
+    case ESP_RST_SW:
+    case ESP_RST_PANIC:
+    case ESP_RST_INT_WDT:
+    case ESP_RST_TASK_WDT:
+    case ESP_RST_WDT:
+    case ESP_RST_DEEPSLEEP:
+        break;
+    default:
+        return false;
+    }
+    size_t size = settings_blob_size(&warm_blob);
+    // A garbage count would make the size run past the struct
+    if (size > sizeof(warm_blob))
+        return false;
+    warm_restored = settings_blob_unpack(&warm_blob, size, params);
+    return warm_restored;
+}
+
+/**
+ * @brief Reports whether warm_cache_load() restored the parameters during this boot.
+ * @return bool True if the boot restored the mirrored parameters, so NVS need not be read.
+ */
+bool warm_cache_restored(void)
+{
+    return warm_restored;
+}
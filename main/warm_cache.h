@@ -0,0 +1,36 @@
+/**
+ * @file warm_cache.h
+ * @brief Header file for the RTC-memory mirror of the live parameters, restoring them on a warm restart without reading NVS.
+ */
+
+#ifndef WARM_CACHE_H
+#define WARM_CACHE_H
+
+#include <stdbool.h>
+#include "user_actions.h"
+
+/**
+ * @brief Mirrors the parameters into RTC memory. Called by the parameter store on every publish.
+ * @param params The parameters just published.
+ */
+void warm_cache_store(const MenuParams_t *params);
+
+/**
+ * @brief Recomputes the mirror's CRC if a publish changed it. Audio task only, once per block.
+ */
+void warm_cache_seal(void);
+
+/**
+ * @brief Restores the mirrored parameters after a warm restart.
+ * @param params Updated with the mirrored parameters if they are valid.
+ * @return bool True if the chip was reset without losing RTC memory and the mirror passed its checks.
+ */
+bool warm_cache_load(MenuParams_t *params);
+
+/**
+ * @brief Reports whether warm_cache_load() restored the parameters during this boot.
+ * @return bool True if the boot restored the mirrored parameters, so NVS need not be read.
+ */
+bool warm_cache_restored(void);
+
+#endif
@@ -5,66 +5,168 @@
 
 #include "waveform_gen.h"
 #include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "pitch_tables.h"
+#include "osc_post.h"
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+#include "esp_cpu.h"
+#include "esp_log.h"
+
+/** @brief Logging tag for the kernel benchmark. */
+#define TAG "waveform_gen"
+
+/** @brief Number of blocks each kernel renders during the benchmark. */
+#define OSC_BENCH_BLOCKS 256
+#endif
 
 /** @brief Audio sample rate (Hz). */
 #define SAMPLE_RATE 44100
 
+/** @brief Converts a smoothing time in milliseconds into samples. */
+#define OSC_RAMP_SAMPLES(ms) ((uint32_t)(ms) * SAMPLE_RATE / 1000)
+
+/** @brief Number of index bits of the sine wave lookup table. */
+#define TABLE_BITS 10
+
 /** @brief Size of the sine wave lookup table. */
-#define TABLE_SIZE 1024
+#define TABLE_SIZE (1 << TABLE_BITS)
+
+/** @brief Right shift that turns a Q32 phase into a table index. */
+#define TABLE_INDEX_SHIFT (32 - TABLE_BITS)
+
+/** @brief Right shift that turns the phase bits below the index into a Q16 interpolation fraction. */
+#define TABLE_FRAC_SHIFT (TABLE_INDEX_SHIFT - 16)
+
+/** @brief Full phase cycle (2^32) as a float, used to convert frequencies into Q32 increments. */
+#define PHASE_CYCLE 4294967296.0f
+
+/** @brief Half a phase cycle (pi radians) in Q32. */
+#define PHASE_HALF 0x80000000u
 
 /** @brief MIDI note number for A4 (440 Hz). */
 #define MIDI_A4 69
 
-/** @brief Reference frequency for A4 (Hz). */
-#define A4_FREQ 440.0f
+_Static_assert(PITCH_TABLE_SAMPLE_RATE == SAMPLE_RATE, "pitch_tables.h was generated for a different sample rate");
+
+/** @brief Lookup table for sine wave, with a guard point so interpolation never wraps the index. */
+static int16_t sine_table[TABLE_SIZE + 1];
 
-/** @brief Number of cents per octave. */
-#define CENTS_PER_OCTAVE 1200.0f
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+/** @brief Number of mipmap levels; level L holds at most 512 >> L harmonics. */
+#define WT_NUM_LEVELS 10
 
-/** @brief Current frequency pitch (MIDI note number). */
-static uint8_t base_freq_pitch = MIDI_A4;
+/** @brief Offset between log2 of the phase increment and the mipmap position. */
+#define WT_LEVEL_LOG2_OFFSET 22
 
-/** @brief Fine frequency adjustment (cents). */
-static int16_t base_freq_fine = 0;
+/** @brief Attenuation for pulse, whose two band-limited saw edges can each overshoot. */
+#define WT_PULSE_SCALE 0.9f
 
-/** @brief Current waveform type. */
-static OscWaveform_t waveform_type = OSC_WAVE_SINE;
+/** @brief Band-limited tables for triangle, saw and square, per mipmap level. */
+static int16_t wt_tables[3][WT_NUM_LEVELS][TABLE_SIZE + 1];
 
-/** @brief Output level (0–65535). */
-static uint16_t level = 65535;
+/** @brief Saw table value for an ideal saw value of 1.0, used to re-centre pulse. */
+static float wt_saw_unit = 32767.0f;
 
-/** @brief Pulse width for pulse wave (0–65535). */
-static uint16_t pulse_width = 32768;
+/** @brief Mipmap level pointers per waveform; sine uses sine_table and pulse reuses saw. */
+static const int16_t *wt_levels[OSC_WAVE_PULSE + 1][WT_NUM_LEVELS];
 
-/** @brief Amplitude modulation slot (0–15 or 0xFF). */
-static uint8_t amp_mod_slot = 0xFF;
+/** @brief Change of the pulse DC offset per unit of pulse width (Q32), for pulse width ramps. */
+static float wt_pulse_dc_slope = 2.0f * 32767.0f / PHASE_CYCLE;
+#endif
 
-/** @brief Frequency modulation slot (0–15 or 0xFF). */
-static uint8_t freq_mod_slot = 0xFF;
+/** @brief De-interleaved TDM modulation input of the block being rendered, or NULL for none. */
+static const int16_t *mod_input = NULL;
 
-/** @brief Sync source slot (0–15 or 0xFF). */
-static uint8_t sync_slot = 0xFF;
+/** @brief Samples per slot in mod_input. */
+static uint32_t mod_input_stride = 0;
 
-/** @brief Lookup table for sine wave. */
-static int16_t sine_table[TABLE_SIZE];
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+/**
+ * @brief Sums one waveform's mipmap levels by additive synthesis from sine_table.
+ * @param dst Destination levels for the waveform, or NULL to only measure the peak.
+ * @param odd_only Only odd harmonics are present (square, triangle).
+ * @param cosine Harmonics are cosines with 1/h^2 amplitude (triangle) instead of sines with 1/h.
+ * @param scale Fourier series scale factor of the waveform times the output gain.
+ * @return float Largest absolute sample over all levels.
+ *
+ * Levels are built from the fewest harmonics upwards, so each harmonic is added once
+ * to the running sum and every level is a snapshot of it.
+ */
+static float wavetable_sum_levels(int16_t (*dst)[TABLE_SIZE + 1], bool odd_only, bool cosine, float scale)
+{
+    static float acc[TABLE_SIZE];
+    uint32_t next_h = 1;
+    float peak = 0.0f;
+    for (int i = 0; i < TABLE_SIZE; i++)
+        acc[i] = 0.0f;
+    for (int lvl = WT_NUM_LEVELS - 1; lvl >= 0; lvl--)
+    {
+        uint32_t max_h = (TABLE_SIZE / 2) >> lvl;
+        if (max_h >= TABLE_SIZE / 2)
+            max_h = TABLE_SIZE / 2 - 1;
+        for (; next_h <= max_h; next_h++)
+        {
+            if (odd_only && !(next_h & 1))
+                continue;
+            float amp = cosine ? scale / (float)(next_h * next_h) : scale / (float)next_h;
+            uint32_t offset = cosine ? TABLE_SIZE / 4 : 0;
+            for (uint32_t i = 0; i < TABLE_SIZE; i++)
+                acc[i] += amp * sine_table[(next_h * i + offset) & (TABLE_SIZE - 1)];
+        }
+        for (int i = 0; i < TABLE_SIZE; i++)
+        {
+            float v = fabsf(acc[i]);
+            if (v > peak)
+                peak = v;
+            if (dst)
+                dst[lvl][i] = (int16_t)(v > 32767.0f ? (acc[i] > 0.0f ? 32767 : -32767) : acc[i]);
+        }
+        if (dst)
+            dst[lvl][TABLE_SIZE] = dst[lvl][0];
+    }
+    return peak;
+}
 
-/** @brief Current phase of the waveform (radians). */
-static float phase = 0.0f;
+/**
+ * @brief Builds one waveform's mipmap levels, normalised so the loudest level peaks at full scale.
+ * @param dst Destination levels for the waveform.
+ * @param odd_only Only odd harmonics are present (square, triangle).
+ * @param cosine Harmonics are cosines with 1/h^2 amplitude (triangle) instead of sines with 1/h.
+ * @param scale Fourier series scale factor of the waveform.
+ * @return float Table value corresponding to an ideal waveform value of 1.0.
+ */
+static float wavetable_build_wave(int16_t (*dst)[TABLE_SIZE + 1], bool odd_only, bool cosine, float scale)
+{
+    // sine_table is already in 16-bit full scale, so the measured peak is relative to 32767
+    float gain = 32767.0f / wavetable_sum_levels(NULL, odd_only, cosine, scale);
+    wavetable_sum_levels(dst, odd_only, cosine, scale * gain);
+    return 32767.0f * gain;
+}
 
 /**
- * @brief Reads a modulation value from a TDM slot.
- * @param slot The TDM slot number (0–15).
- * @return float The modulation value (placeholder implementation).
- * @note Requires implementation for I2C or shared memory access.
+ * @brief Precomputes the band-limited mipmaps for every waveform.
  */
-static float read_tdm_slot(uint8_t slot)
+static void wavetable_build(void)
 {
-    // TODO: Implement TDM buffer access via I2C or shared memory
-    return 0.0f;
+    wavetable_build_wave(wt_tables[0], true, true, 8.0f / (float)(M_PI * M_PI));
+    wt_saw_unit = wavetable_build_wave(wt_tables[1], false, false, 2.0f / (float)M_PI);
+    wt_pulse_dc_slope = 2.0f * wt_saw_unit / PHASE_CYCLE;
+    wavetable_build_wave(wt_tables[2], true, false, 4.0f / (float)M_PI);
+    for (int lvl = 0; lvl < WT_NUM_LEVELS; lvl++)
+    {
+        wt_levels[OSC_WAVE_SINE][lvl] = sine_table;
+        wt_levels[OSC_WAVE_TRIANGLE][lvl] = wt_tables[0][lvl];
+        wt_levels[OSC_WAVE_SAW][lvl] = wt_tables[1][lvl];
+        wt_levels[OSC_WAVE_SQUARE][lvl] = wt_tables[2][lvl];
+        wt_levels[OSC_WAVE_PULSE][lvl] = wt_tables[1][lvl];
+    }
 }
+#endif
 
 /**
- * @brief Initializes the waveform generator with the specified sample rate.
+ * @brief Builds the lookup tables shared by all oscillator instances.
  * @param sample_rate The audio sample rate in Hz (e.g., 44100).
  */
 void waveform_init(uint32_t sample_rate)
@@ -73,10 +175,54 @@ void waveform_init(uint32_t sample_rate)
     {
         sine_table[i] = (int16_t)(32767.0f * sinf(2.0f * M_PI * i / TABLE_SIZE));
     }
+    sine_table[TABLE_SIZE] = sine_table[0];
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+    wavetable_build();
+#endif
 }
 
 /**
- * @brief Sets the parameters for waveform generation.
+ * @brief Initializes an oscillator instance with default parameters and zero phase.
+ * @param osc The oscillator to initialize.
+ *
+ * Parameter changes are applied as steps until osc_set_smoothing() is called.
+ */
+void osc_init(osc_t *osc)
+{
+    *osc = (osc_t){
+        .phase = 0,
+        .waveform = OSC_WAVE_SINE,
+        .level = 65535,
+        .pulse_width = 32768,
+        .freq_fine = 0,
+        .freq_pitch = MIDI_A4,
+        .amp_mod_slot = 0xFF,
+        .freq_mod_slot = 0xFF,
+        .sync_slot = 0xFF,
+        .dirty = OSC_DIRTY_ALL,
+        .sync_prev = 0.0f,
+    };
+}
+
+/**
+ * @brief Sets the smoothing times of an oscillator instance.
+ * @param osc The oscillator to update.
+ * @param pitch_ms Glide time for pitch and fine tune changes (0 for a step).
+ * @param level_ms Ramp time for level changes (0 for a step).
+ * @param pw_ms Ramp time for pulse width changes (0 for a step).
+ *
+ * Ramps already in progress keep their length; the new times apply from the next change.
+ */
+void osc_set_smoothing(osc_t *osc, uint16_t pitch_ms, uint16_t level_ms, uint16_t pw_ms)
+{
+    osc->ramp.inc_samples = OSC_RAMP_SAMPLES(pitch_ms);
+    osc->ramp.gain_samples = OSC_RAMP_SAMPLES(level_ms);
+    osc->ramp.pw_samples = OSC_RAMP_SAMPLES(pw_ms);
+}
+
+/**
+ * @brief Sets the parameters of an oscillator instance.
+ * @param osc The oscillator to update.
  * @param freq_pitch MIDI note number for frequency (0–127).
  * @param freq_fine Fine frequency adjustment in cents (-100 to 100).
  * @param waveform Waveform type (sine, triangle, saw, square, pulse).
@@ -85,59 +231,658 @@ void waveform_init(uint32_t sample_rate)
  * @param amp_slot Amplitude modulation slot (0–15 or 0xFF for none).
  * @param freq_slot Frequency modulation slot (0–15 or 0xFF for none).
  * @param sync Sync source slot (0–15 or 0xFF for none).
+ *
+ * Only parameters whose value actually changes are flagged for recomputation, so calling this
+ * every block with the same values costs a few comparisons.
+ */
+void osc_set_params(osc_t *osc, uint8_t freq_pitch, int16_t freq_fine, OscWaveform_t waveform, uint16_t level, uint16_t pw, uint8_t amp_slot, uint8_t freq_slot, uint8_t sync)
+{
+    freq_pitch = freq_pitch > 127 ? 127 : freq_pitch;
+    freq_fine = freq_fine > 100 ? 100 : (freq_fine < -100 ? -100 : freq_fine);
+    if (freq_pitch != osc->freq_pitch || freq_fine != osc->freq_fine)
+    {
+        osc->freq_pitch = freq_pitch;
+        osc->freq_fine = freq_fine;
+        osc->dirty |= OSC_DIRTY_PITCH;
+    }
+    if (waveform != osc->waveform)
+    {
+        osc->waveform = waveform;
+        osc->dirty |= OSC_DIRTY_WAVE;
+    }
+    if (level != osc->level)
+    {
+        osc->level = level;
+        osc->dirty |= OSC_DIRTY_LEVEL;
+    }
+    if (pw != osc->pulse_width)
+    {
+        osc->pulse_width = pw;
+        osc->dirty |= OSC_DIRTY_PW;
+    }
+    osc->amp_mod_slot = amp_slot;
+    osc->freq_mod_slot = freq_slot;
+    osc->sync_slot = sync;
+}
+
+/**
+ * @brief Reads the sine table at a Q32 phase with linear interpolation.
+ * @param ph Phase (Q32).
+ * @return float Interpolated sine sample (-32767 to 32767).
+ */
+static inline float sine_lookup(uint32_t ph)
+{
+    uint32_t index = ph >> TABLE_INDEX_SHIFT;
+    int32_t frac = (int32_t)((ph >> TABLE_FRAC_SHIFT) & 0xFFFF);
+    int32_t s0 = sine_table[index];
+    int32_t s1 = sine_table[index + 1];
+    return (float)(s0 + (((s1 - s0) * frac) >> 16));
+}
+
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+/**
+ * @brief PolyBLEP residual for a step discontinuity at phase 0.
+ * @param ph Phase relative to the discontinuity (Q32).
+ * @param inc Phase increment per sample (Q32).
+ * @param inv_inc Reciprocal of the phase increment, precomputed per block.
+ * @return float Residual for a step of height +2 (scale by half the step height).
+ */
+static inline float poly_blep(uint32_t ph, uint32_t inc, float inv_inc)
+{
+    if (ph < inc)
+    {
+        float x = (float)ph * inv_inc;
+        return x + x - x * x - 1.0f;
+    }
+    if (ph > ~inc)
+    {
+        float x = -(float)(0u - ph) * inv_inc;
+        return x * x + x + x + 1.0f;
+    }
+    return 0.0f;
+}
+
+/**
+ * @brief PolyBLAMP residual for a slope discontinuity at phase 0.
+ * @param ph Phase relative to the discontinuity (Q32).
+ * @param inc Phase increment per sample (Q32).
+ * @param inv_inc Reciprocal of the phase increment, precomputed per block.
+ * @return float Residual for a unit slope change (scale by slope change times dt).
+ */
+static inline float poly_blamp(uint32_t ph, uint32_t inc, float inv_inc)
+{
+    float x;
+    if (ph < inc)
+        x = 1.0f - (float)ph * inv_inc;
+    else if (ph > ~inc)
+        x = 1.0f - (float)(0u - ph) * inv_inc;
+    else
+        return 0.0f;
+    return x * x * x * (1.0f / 6.0f);
+}
+#endif
+
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+/**
+ * @brief Reads an interpolated sample from a table of TABLE_SIZE + 1 entries.
+ * @param table The table to read.
+ * @param ph Phase (Q32).
+ * @return int32_t Interpolated sample.
  */
-void waveform_set_params(uint8_t freq_pitch, int16_t freq_fine, OscWaveform_t waveform, uint16_t lvl, uint16_t pw, uint8_t amp_slot, uint8_t freq_slot, uint8_t sync)
+static inline int32_t table_lookup(const int16_t *table, uint32_t ph)
 {
-    base_freq_pitch = freq_pitch > 127 ? 127 : freq_pitch;
-    base_freq_fine = freq_fine > 100 ? 100 : (freq_fine < -100 ? -100 : freq_fine);
-    waveform_type = waveform;
-    level = lvl;
-    pulse_width = pw;
-    amp_mod_slot = amp_slot;
-    freq_mod_slot = freq_slot;
-    sync_slot = sync;
+    uint32_t index = ph >> TABLE_INDEX_SHIFT;
+    int32_t frac = (int32_t)((ph >> TABLE_FRAC_SHIFT) & 0xFFFF);
+    int32_t s0 = table[index];
+    return s0 + (((table[index + 1] - s0) * frac) >> 16);
 }
 
 /**
- * @brief Generates a buffer of waveform samples.
+ * @brief Picks the two mipmap levels and blend factor for a phase increment.
+ * @param inc Phase increment per sample (Q32).
+ * @param lo Receives the level with more harmonics.
+ * @param blend Receives the weight of level lo + 1 (0.0–1.0).
+ *
+ * Level lo is chosen one above the octave position so its highest harmonic stays below
+ * Nyquist across the whole octave; the blend fades towards the next level as pitch rises.
+ */
+static void wavetable_select(uint32_t inc, int *lo, float *blend)
+{
+    if (inc == 0)
+    {
+        *lo = 0;
+        *blend = 0.0f;
+        return;
+    }
+    int msb = 31 - __builtin_clz(inc);
+    int pos = msb - WT_LEVEL_LOG2_OFFSET + 1;
+    // Linear mantissa approximation of log2; exact at octave boundaries
+    float frac = msb >= 16 ? (float)((inc >> (msb - 16)) & 0xFFFF) * (1.0f / 65536.0f)
+                           : (float)((inc << (16 - msb)) & 0xFFFF) * (1.0f / 65536.0f);
+    if (pos < 0)
+    {
+        *lo = 0;
+        *blend = 0.0f;
+    }
+    else if (pos >= WT_NUM_LEVELS - 1)
+    {
+        *lo = WT_NUM_LEVELS - 2;
+        *blend = 1.0f;
+    }
+    else
+    {
+        *lo = pos;
+        *blend = frac;
+    }
+}
+#endif
+
+/** @brief Render kernel specialized for one waveform and modulation combination. */
+typedef void (*osc_kernel_fn)(osc_t *osc, const float *fm, const float *sync, float *out, uint32_t num_samples);
+
+/** @brief Modulation flag: frequency modulation input is active. */
+#define OSC_MOD_FM (1u << 0)
+
+/** @brief Modulation flag: sync input is active. */
+#define OSC_MOD_SYNC (1u << 1)
+
+/** @brief Modulation flag: a pitch or pulse width smoothing ramp is in progress. */
+#define OSC_MOD_RAMP (1u << 2)
+
+/** @brief Number of phase modulation and ramp combinations, one kernel each. Amplitude modulation and level ramps are applied by the post stage. */
+#define OSC_MOD_COMBOS 8
+
+/** @brief Longest run of samples rendered by one kernel call (size of the modulation buffers). */
+#define OSC_MAX_BLOCK 64
+
+/** @brief Converts a frequency modulation value in radians per sample into a Q32 increment. */
+#define FM_RAD_TO_INC (PHASE_CYCLE / (2.0f * (float)M_PI))
+
+/**
+ * @brief Reads a run of modulation values from a TDM slot of the current input block.
+ * @param slot The TDM slot number (0–15).
+ * @param dst Destination for one value per sample (-1.0 to 1.0).
+ * @param offset Position of the run within the block.
+ * @param num_samples Number of samples to read.
+ */
+static void read_tdm_block(uint8_t slot, float *dst, uint32_t offset, uint32_t num_samples)
+{
+    if (!mod_input || slot >= 16 || offset + num_samples > mod_input_stride)
+    {
+        for (uint32_t i = 0; i < num_samples; i++)
+            dst[i] = 0.0f;
+        return;
+    }
+    const int16_t *src = mod_input + slot * mod_input_stride + offset;
+    for (uint32_t i = 0; i < num_samples; i++)
+        dst[i] = (float)src[i] * (1.0f / 32768.0f);
+}
+
+/**
+ * @brief Computes one sample of a waveform at a phase, without gain.
+ * @param blk Derived values of the oscillator.
+ * @param wave Waveform; always a constant so each kernel keeps only its own case.
+ * @param phase Phase (Q32).
+ * @return float Sample in 16-bit full scale.
+ */
+static inline __attribute__((always_inline)) float osc_wave_sample(const osc_derived_t *blk, OscWaveform_t wave, uint32_t phase)
+{
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+    float a = (float)table_lookup(blk->tab_lo, phase);
+    float sample = a + blk->blend * ((float)table_lookup(blk->tab_hi, phase) - a);
+    if (wave == OSC_WAVE_PULSE)
+    {
+        // Pulse is the difference of two saws offset by the pulse width, re-centred around zero
+        uint32_t ph2 = phase - blk->pw_threshold;
+        float b = (float)table_lookup(blk->tab_lo, ph2);
+        sample = (sample - b - blk->blend * ((float)table_lookup(blk->tab_hi, ph2) - b) - blk->pulse_dc) * WT_PULSE_SCALE;
+    }
+    return sample;
+#else
+    float sample = 0.0f;
+    switch (wave)
+    {
+    case OSC_WAVE_SINE:
+        sample = sine_lookup(phase);
+        break;
+    case OSC_WAVE_TRIANGLE:
+    {
+        // |phase - pi| spans 0..2^31; rescale to -32767..32767
+        uint32_t dist = phase < PHASE_HALF ? PHASE_HALF - phase : phase - PHASE_HALF;
+        sample = (float)(int32_t)(dist >> 15) * (32767.0f / 32768.0f) - 32767.0f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+        sample += blk->blamp_scale * (poly_blamp(phase - PHASE_HALF, blk->inc, blk->inv_inc) -
+                                      poly_blamp(phase, blk->inc, blk->inv_inc));
+#endif
+        break;
+    }
+    case OSC_WAVE_SAW:
+        sample = (float)((int32_t)(0x7FFFFFFFu - phase) >> 16);
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+        sample += 32767.0f * poly_blep(phase, blk->inc, blk->inv_inc);
+#endif
+        break;
+    case OSC_WAVE_SQUARE:
+        sample = (phase < PHASE_HALF) ? 32767.0f : -32767.0f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+        sample += 32767.0f * (poly_blep(phase, blk->inc, blk->inv_inc) -
+                              poly_blep(phase + PHASE_HALF, blk->inc, blk->inv_inc));
+#endif
+        break;
+    case OSC_WAVE_PULSE:
+        sample = (phase < blk->pw_threshold) ? 32767.0f : -32767.0f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+        sample += 32767.0f * (poly_blep(phase, blk->inc, blk->inv_inc) -
+                              poly_blep(phase - blk->pw_threshold, blk->inc, blk->inv_inc));
+#endif
+        break;
+    }
+    return sample;
+#endif
+}
+
+/**
+ * @brief Generic render loop, inlined into each specialized kernel.
+ * @param osc The oscillator to render.
+ * @param fm Frequency modulation input (radians per sample), one value per sample.
+ * @param sync Sync input, one value per sample.
+ * @param out Output samples in 16-bit full scale, before gain.
+ * @param num_samples Number of samples to generate (at most OSC_MAX_BLOCK).
+ * @param wave Waveform; a constant in every kernel.
+ * @param mods Combination of OSC_MOD_* flags; a constant in every kernel.
+ */
+static inline __attribute__((always_inline)) void osc_kernel(osc_t *osc, const float *fm, const float *sync_in, float *out, uint32_t num_samples, OscWaveform_t wave, unsigned mods)
+{
+    osc_derived_t blk = osc->derived;
+    uint32_t phase = osc->phase;
+    float sync_prev = osc->sync_prev;
+    float inc_f = (float)blk.inc;
+    for (uint32_t i = 0; i < num_samples; i++)
+    {
+        if (mods & OSC_MOD_SYNC)
+        {
+            // Hard sync: restart the cycle on a rising zero crossing of the sync input
+            float sync = sync_in[i];
+            if (sync > 0.0f && sync_prev <= 0.0f)
+                phase = 0;
+            sync_prev = sync;
+        }
+        out[i] = osc_wave_sample(&blk, wave, phase);
+        if (mods & OSC_MOD_FM)
+            phase += blk.inc + (uint32_t)(int32_t)(fm[i] * FM_RAD_TO_INC);
+        else
+            phase += blk.inc;
+        if (mods & OSC_MOD_RAMP)
+        {
+            // One multiply or add per ramped value; the steps were computed when the ramp started
+            inc_f *= osc->ramp.inc_ratio;
+            blk.inc = (uint32_t)inc_f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+            blk.inv_inc *= osc->ramp.inv_inc_ratio;
+            blk.blamp_scale *= osc->ramp.inc_ratio;
+#endif
+            blk.pw_threshold += (uint32_t)osc->ramp.pw_step;
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+            if (wave == OSC_WAVE_PULSE)
+                blk.pulse_dc = wt_saw_unit - (float)blk.pw_threshold * wt_pulse_dc_slope;
+#endif
+        }
+    }
+    osc->phase = phase;
+    osc->sync_prev = sync_prev;
+    if (mods & OSC_MOD_RAMP)
+        osc->derived = blk;
+}
+/** @brief Defines the kernel for one waveform and modulation combination. */
+#define OSC_KERNEL(name, wave, mods)                                                                 \
+    static void osc_kernel_##name##_##mods(osc_t *osc, const float *fm, const float *sync, float *out, \
+                                           uint32_t n)                                               \
+    {                                                                                                \
+        osc_kernel(osc, fm, sync, out, n, wave, mods);                                               \
+    }
+
+/** @brief Defines the kernels for every modulation combination of one waveform. */
+#define OSC_KERNEL_SET(name, wave) \
+    OSC_KERNEL(name, wave, 0)      \
+    OSC_KERNEL(name, wave, 1)      \
+    OSC_KERNEL(name, wave, 2)      \
+    OSC_KERNEL(name, wave, 3)      \
+    OSC_KERNEL(name, wave, 4)      \
+    OSC_KERNEL(name, wave, 5)      \
+    OSC_KERNEL(name, wave, 6)      \
+    OSC_KERNEL(name, wave, 7)
+
+/** @brief Dispatch table row for one waveform, indexed by modulation combination. */
+#define OSC_KERNEL_ROW(name)                                                                     \
+    {osc_kernel_##name##_0, osc_kernel_##name##_1, osc_kernel_##name##_2, osc_kernel_##name##_3, \
+     osc_kernel_##name##_4, osc_kernel_##name##_5, osc_kernel_##name##_6, osc_kernel_##name##_7}
+
+OSC_KERNEL_SET(sine, OSC_WAVE_SINE)
+OSC_KERNEL_SET(triangle, OSC_WAVE_TRIANGLE)
+OSC_KERNEL_SET(saw, OSC_WAVE_SAW)
+OSC_KERNEL_SET(square, OSC_WAVE_SQUARE)
+OSC_KERNEL_SET(pulse, OSC_WAVE_PULSE)
+
+/** @brief Render kernels indexed by waveform and modulation combination. */
+static const osc_kernel_fn osc_kernels[OSC_WAVE_PULSE + 1][OSC_MOD_COMBOS] = {
+    [OSC_WAVE_SINE] = OSC_KERNEL_ROW(sine),
+    [OSC_WAVE_TRIANGLE] = OSC_KERNEL_ROW(triangle),
+    [OSC_WAVE_SAW] = OSC_KERNEL_ROW(saw),
+    [OSC_WAVE_SQUARE] = OSC_KERNEL_ROW(square),
+    [OSC_WAVE_PULSE] = OSC_KERNEL_ROW(pulse),
+};
+
+/**
+ * @brief Sets the phase increment and the values derived from it.
+ * @param d Derived values to update.
+ * @param inc Phase increment (Q32).
+ */
+static void osc_set_inc(osc_derived_t *d, uint32_t inc)
+{
+    d->inc = inc;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+    d->inv_inc = 1.0f / (float)inc;
+    // Triangle slope changes by 8 (in units of full scale per cycle) at each corner
+    d->blamp_scale = 8.0f * 32767.0f * (float)inc * (1.0f / PHASE_CYCLE);
+#endif
+}
+
+/**
+ * @brief Sets the pulse falling edge and the values derived from it.
+ * @param d Derived values to update.
+ * @param pw_threshold Pulse falling edge (Q32).
+ */
+static void osc_set_pw(osc_derived_t *d, uint32_t pw_threshold)
+{
+    d->pw_threshold = pw_threshold;
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+    d->pulse_dc = wt_saw_unit * (1.0f - 2.0f * (float)pw_threshold * (1.0f / PHASE_CYCLE));
+#endif
+}
+
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+/**
+ * @brief Selects the mipmap levels matching the current phase increment and waveform.
+ * @param osc The oscillator to update.
+ */
+static void osc_select_tables(osc_t *osc)
+{
+    osc_derived_t *d = &osc->derived;
+    if ((unsigned)osc->waveform > OSC_WAVE_PULSE)
+        return;
+    int lvl;
+    wavetable_select(d->inc, &lvl, &d->blend);
+    d->tab_lo = wt_levels[osc->waveform][lvl];
+    d->tab_hi = wt_levels[osc->waveform][lvl + 1];
+}
+#endif
+
+/**
+ * @brief Recomputes the derived values of an oscillator whose parameters are flagged dirty.
+ * @param osc The oscillator to update; its dirty flags are cleared.
+ *
+ * Unless OSC_DIRTY_SNAP is set, a changed level, pulse width or pitch starts a smoothing ramp
+ * from the current value instead. Its per-sample step, and the powf() for the pitch ratio, are
+ * computed here once per change, never per sample.
+ */
+static void osc_update_derived(osc_t *osc)
+{
+    osc_derived_t *d = &osc->derived;
+    osc_ramp_t *r = &osc->ramp;
+    unsigned dirty = osc->dirty;
+    bool snap = dirty & OSC_DIRTY_SNAP;
+    if (dirty & OSC_DIRTY_PITCH)
+    {
+        uint32_t inc = (uint32_t)(((uint64_t)note_inc_table[osc->freq_pitch] *
+                                   cents_ratio_table[osc->freq_fine - PITCH_TABLE_FINE_MIN]) >>
+                                  PITCH_TABLE_RATIO_BITS);
+        if (snap || r->inc_samples == 0 || inc == d->inc)
+        {
+            osc_set_inc(d, inc);
+            r->inc_remaining = 0;
+            r->inc_ratio = 1.0f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+            r->inv_inc_ratio = 1.0f;
+#endif
+        }
+        else
+        {
+            r->inc_target = inc;
+            r->inc_remaining = r->inc_samples;
+            r->inc_ratio = powf((float)inc / (float)d->inc, 1.0f / (float)r->inc_samples);
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+            r->inv_inc_ratio = 1.0f / r->inc_ratio;
+#endif
+        }
+    }
+    if (dirty & OSC_DIRTY_PW)
+    {
+        uint32_t pw_threshold = (uint32_t)osc->pulse_width << 16;
+        if (snap || r->pw_samples == 0 || pw_threshold == d->pw_threshold)
+        {
+            osc_set_pw(d, pw_threshold);
+            r->pw_remaining = 0;
+            r->pw_step = 0;
+        }
+        else
+        {
+            r->pw_target = pw_threshold;
+            r->pw_remaining = r->pw_samples;
+            r->pw_step = (int32_t)((float)((int64_t)pw_threshold - (int64_t)d->pw_threshold) *
+                                   (1.0f / (float)r->pw_samples));
+        }
+    }
+    if (dirty & OSC_DIRTY_LEVEL)
+    {
+        float gain = (float)osc->level / 65535.0f;
+        if (snap || r->gain_samples == 0 || gain == d->gain)
+        {
+            d->gain = gain;
+            r->gain_remaining = 0;
+        }
+        else
+        {
+            r->gain_target = gain;
+            r->gain_remaining = r->gain_samples;
+            r->gain_step = (gain - d->gain) * (1.0f / (float)r->gain_samples);
+        }
+    }
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+    if (dirty & (OSC_DIRTY_PITCH | OSC_DIRTY_WAVE))
+        osc_select_tables(osc);
+#endif
+    osc->dirty = 0;
+}
+
+/**
+ * @brief Returns how many samples can be rendered before the next smoothing ramp ends.
+ * @param osc The oscillator.
+ * @param max_samples Upper bound, returned if no ramp ends sooner.
+ * @return uint32_t Samples to render with constant ramp steps.
+ */
+static uint32_t osc_ramp_span(const osc_t *osc, uint32_t max_samples)
+{
+    const osc_ramp_t *r = &osc->ramp;
+    uint32_t n = max_samples;
+    if (r->inc_remaining && r->inc_remaining < n)
+        n = r->inc_remaining;
+    if (r->pw_remaining && r->pw_remaining < n)
+        n = r->pw_remaining;
+    if (r->gain_remaining && r->gain_remaining < n)
+        n = r->gain_remaining;
+    return n;
+}
+
+/**
+ * @brief Counts rendered samples off the smoothing ramps and lands finished ramps exactly on target.
+ * @param osc The oscillator.
+ * @param num_samples Samples rendered, at most osc_ramp_span().
+ */
+static void osc_ramp_advance(osc_t *osc, uint32_t num_samples)
+{
+    osc_derived_t *d = &osc->derived;
+    osc_ramp_t *r = &osc->ramp;
+    if (r->inc_remaining)
+    {
+        r->inc_remaining -= num_samples;
+        if (!r->inc_remaining)
+        {
+            osc_set_inc(d, r->inc_target);
+            r->inc_ratio = 1.0f;
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+            r->inv_inc_ratio = 1.0f;
+#endif
+        }
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+        osc_select_tables(osc);
+#endif
+    }
+    if (r->pw_remaining)
+    {
+        r->pw_remaining -= num_samples;
+        if (!r->pw_remaining)
+        {
+            osc_set_pw(d, r->pw_target);
+            r->pw_step = 0;
+        }
+    }
+    if (r->gain_remaining)
+    {
+        r->gain_remaining -= num_samples;
+        if (!r->gain_remaining)
+            d->gain = r->gain_target;
+    }
+}
+
+/**
+ * @brief Sets the TDM modulation input used by the following render calls.
+ * @param slots De-interleaved slot samples, slot s starting at slots + s * stride, or NULL for none.
+ * @param stride Samples per slot; render calls may cover at most this many samples.
+ */
+void waveform_set_mod_input(const int16_t *slots, uint32_t stride)
+{
+    mod_input = slots;
+    mod_input_stride = stride;
+}
+
+/**
+ * @brief Renders up to OSC_MAX_BLOCK float samples with gain applied.
+ * @param osc The oscillator to render.
+ * @param out Output samples in 16-bit full scale.
+ * @param offset Position of the run within the modulation input block.
+ * @param num_samples Number of samples to generate (at most OSC_MAX_BLOCK).
+ *
+ * The waveform and active modulation inputs cannot change inside a block, so the kernel is
+ * picked from osc_kernels once per run and the derived values are refreshed only if a
+ * parameter changed; gain and amplitude modulation are then applied by the vector post
+ * stage. While a smoothing ramp is running the run is further split where the ramp ends.
+ */
+static void osc_render_run(osc_t *osc, float *out, uint32_t offset, uint32_t num_samples)
+{
+    if ((unsigned)osc->waveform > OSC_WAVE_PULSE)
+    {
+        for (uint32_t i = 0; i < num_samples; i++)
+            out[i] = 0.0f;
+        return;
+    }
+    float am[OSC_MAX_BLOCK] __attribute__((aligned(16)));
+    float fm[OSC_MAX_BLOCK], sync[OSC_MAX_BLOCK];
+    unsigned mods = (osc->freq_mod_slot != 0xFF ? OSC_MOD_FM : 0) |
+                    (osc->sync_slot != 0xFF ? OSC_MOD_SYNC : 0);
+    if (osc->dirty)
+        osc_update_derived(osc);
+
+    if (mods & OSC_MOD_FM)
+        read_tdm_block(osc->freq_mod_slot, fm, offset, num_samples);
+    if (mods & OSC_MOD_SYNC)
+        read_tdm_block(osc->sync_slot, sync, offset, num_samples);
+    if (osc->amp_mod_slot != 0xFF)
+        read_tdm_block(osc->amp_mod_slot, am, offset, num_samples);
+
+    // Split where a smoothing ramp ends so every kernel call has constant ramp steps
+    for (uint32_t pos = 0; pos < num_samples;)
+    {
+        const osc_ramp_t *r = &osc->ramp;
+        uint32_t n = osc_ramp_span(osc, num_samples - pos);
+        unsigned run_mods = mods | (r->inc_remaining || r->pw_remaining ? OSC_MOD_RAMP : 0);
+        osc_kernels[osc->waveform][run_mods](osc, fm + pos, sync + pos, out + pos, n);
+        if (osc->amp_mod_slot != 0xFF)
+            osc_post_mul_f32(out + pos, am + pos, out + pos, n);
+        if (r->gain_remaining)
+            osc->derived.gain = osc_post_ramp_f32(out + pos, out + pos, n, osc->derived.gain, r->gain_step);
+        else
+            osc_post_scale_f32(out + pos, out + pos, n, osc->derived.gain);
+        osc_ramp_advance(osc, n);
+        pos += n;
+    }
+}
+/**
+ * @brief Renders a buffer of float samples from an oscillator instance, with gain applied.
+ * @param osc The oscillator to render.
+ * @param out Output samples in 16-bit full scale, ready to mix with osc_post_mix_f32().
+ * @param num_samples Number of samples to generate.
+ */
+void osc_render_f32(osc_t *osc, float *out, uint32_t num_samples)
+{
+    for (uint32_t offset = 0; offset < num_samples; offset += OSC_MAX_BLOCK)
+    {
+        uint32_t n = num_samples - offset < OSC_MAX_BLOCK ? num_samples - offset : OSC_MAX_BLOCK;
+        osc_render_run(osc, out + offset, offset, n);
+    }
+}
+
+/**
+ * @brief Renders a buffer of samples from an oscillator instance.
+ * @param osc The oscillator to render.
  * @param buffer Pointer to the output buffer for 16-bit samples.
  * @param num_samples Number of samples to generate.
  */
-void waveform_generate(int16_t *buffer, uint32_t num_samples)
+void osc_render(osc_t *osc, int16_t *buffer, uint32_t num_samples)
 {
-    float semitones = (float)(base_freq_pitch - MIDI_A4) + (float)base_freq_fine / CENTS_PER_OCTAVE * 12.0f;
-    float base_frequency = A4_FREQ * powf(2.0f, semitones / 12.0f);
-    float phase_inc = 2.0f * M_PI * base_frequency / SAMPLE_RATE;
-    float pw_ratio = (float)pulse_width / 65535.0f;
-    float amp_mod = (amp_mod_slot != 0xFF) ? read_tdm_slot(amp_mod_slot) : 1.0f;
-    float freq_mod = (freq_mod_slot != 0xFF) ? read_tdm_slot(freq_mod_slot) : 0.0f;
+    float out[OSC_MAX_BLOCK] __attribute__((aligned(16)));
+    for (uint32_t offset = 0; offset < num_samples; offset += OSC_MAX_BLOCK)
+    {
+        uint32_t n = num_samples - offset < OSC_MAX_BLOCK ? num_samples - offset : OSC_MAX_BLOCK;
+        osc_render_run(osc, out, offset, n);
+        osc_post_to_s16(out, buffer + offset, n);
+    }
+}
 
-    for (uint32_t i = 0; i < num_samples; i++)
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+/**
+ * @brief Measures and logs the cycles per sample of every render kernel.
+ *
+ * Each kernel renders OSC_BENCH_BLOCKS blocks of OSC_MAX_BLOCK samples on a scratch
+ * oscillator at A4 with all modulation inputs driven by a slow sine, followed by the
+ * post stages on their own (see osc_post_benchmark()).
+ */
+void osc_benchmark_kernels(void)
+{
+    static const char *wave_names[] = {"sine", "triangle", "saw", "square", "pulse"};
+    static const char *mod_names[] = {"none", "FM", "sync", "FM+sync", "ramp", "FM+ramp", "sync+ramp", "FM+sync+ramp"};
+    float buffer[OSC_MAX_BLOCK] __attribute__((aligned(16)));
+    float mod[OSC_MAX_BLOCK];
+    for (int i = 0; i < OSC_MAX_BLOCK; i++)
+        mod[i] = sinf(2.0f * (float)M_PI * i / OSC_MAX_BLOCK);
+
+    for (int wave = OSC_WAVE_SINE; wave <= OSC_WAVE_PULSE; wave++)
     {
-        float sample = 0.0f;
-        uint32_t index = (uint32_t)(phase * TABLE_SIZE / (2.0f * M_PI)) % TABLE_SIZE;
-        switch (waveform_type)
+        for (unsigned mods = 0; mods < OSC_MOD_COMBOS; mods++)
         {
-        case OSC_WAVE_SINE:
-            sample = sine_table[index];
-            break;
-        case OSC_WAVE_TRIANGLE:
-            sample = 32767.0f * (2.0f * fabs(phase / M_PI - 1.0f) - 1.0f);
-            break;
-        case OSC_WAVE_SAW:
-            sample = 32767.0f * (1.0f - (phase / M_PI));
-            break;
-        case OSC_WAVE_SQUARE:
-            sample = (phase < M_PI) ? 32767.0f : -32767.0f;
-            break;
-        case OSC_WAVE_PULSE:
-            sample = (phase < 2.0f * M_PI * pw_ratio) ? 32767.0f : -32767.0f;
-            break;
+            osc_t osc;
+            osc_init(&osc);
+            osc.waveform = (OscWaveform_t)wave;
+            osc_update_derived(&osc);
+            osc_kernel_fn kernel = osc_kernels[wave][mods];
+            uint32_t start = esp_cpu_get_cycle_count();
+            for (int b = 0; b < OSC_BENCH_BLOCKS; b++)
+                kernel(&osc, mod, mod, buffer, OSC_MAX_BLOCK);
+            uint32_t cycles = esp_cpu_get_cycle_count() - start;
+            ESP_LOGI(TAG, "kernel %-8s %-12s %6.1f cycles/sample", wave_names[wave], mod_names[mods],
+                     (double)cycles / (OSC_BENCH_BLOCKS * OSC_MAX_BLOCK));
         }
-        sample *= (float)level / 65535.0f * amp_mod;
-        buffer[i] = (int16_t)sample;
-        phase += phase_inc + freq_mod;
-        if (phase >= 2.0f * M_PI)
-            phase -= 2.0f * M_PI;
     }
-}
\ No newline at end of file
+
+    osc_post_benchmark();
+}
+#endif
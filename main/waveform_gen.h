@@ -8,15 +8,125 @@
 
 #include <stdint.h>
 #include "synth_constants.h"
+#include "sdkconfig.h"
+
+/** @brief Dirty flag: pitch or fine tune changed (phase increment and everything derived from it). */
+#define OSC_DIRTY_PITCH (1u << 0)
+
+/** @brief Dirty flag: waveform changed. */
+#define OSC_DIRTY_WAVE (1u << 1)
+
+/** @brief Dirty flag: pulse width changed. */
+#define OSC_DIRTY_PW (1u << 2)
+
+/** @brief Dirty flag: level changed. */
+#define OSC_DIRTY_LEVEL (1u << 3)
+
+/** @brief Dirty flag: jump straight to the new values instead of smoothing towards them. */
+#define OSC_DIRTY_SNAP (1u << 4)
+
+/** @brief All dirty flags. */
+#define OSC_DIRTY_ALL (OSC_DIRTY_PITCH | OSC_DIRTY_WAVE | OSC_DIRTY_PW | OSC_DIRTY_LEVEL | OSC_DIRTY_SNAP)
+
+/**
+ * @brief Values derived from the oscillator parameters and shared by every sample of a block.
+ */
+typedef struct
+{
+    uint32_t inc;          ///< Phase increment per sample (Q32)
+    uint32_t pw_threshold; ///< Pulse falling edge (Q32)
+    float gain;            ///< Output gain from level, applied by the post stage
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+    float inv_inc;     ///< Reciprocal of inc
+    float blamp_scale; ///< Triangle corner PolyBLAMP scale
+#endif
+#ifdef CONFIG_OSC_ENGINE_WAVETABLE
+    const int16_t *tab_lo; ///< Mipmap level with more harmonics
+    const int16_t *tab_hi; ///< Next mipmap level
+    float blend;           ///< Weight of tab_hi
+    float pulse_dc;        ///< Offset re-centring the pulse made of two saws
+#endif
+} osc_derived_t;
+
+/**
+ * @brief Smoothing ramps in progress, moving the derived values towards their targets, and their lengths.
+ *
+ * Level and pulse width ramp linearly and pitch ramps by a constant ratio per sample, so each
+ * sample only adds or multiplies by a step computed once when the ramp starts.
+ */
+typedef struct
+{
+    uint32_t inc_samples;     ///< Pitch glide length in samples (0 for a step)
+    uint32_t pw_samples;      ///< Pulse width ramp length in samples (0 for a step)
+    uint32_t gain_samples;    ///< Level ramp length in samples (0 for a step)
+    uint32_t inc_remaining;   ///< Samples left in the pitch ramp (0 when idle)
+    uint32_t inc_target;      ///< Phase increment at the end of the pitch ramp
+    float inc_ratio;          ///< Phase increment ratio per sample
+#ifdef CONFIG_OSC_ENGINE_POLYBLEP
+    float inv_inc_ratio;      ///< Reciprocal of inc_ratio
+#endif
+    uint32_t pw_remaining;    ///< Samples left in the pulse width ramp (0 when idle)
+    uint32_t pw_target;       ///< Pulse falling edge at the end of the ramp (Q32)
+    int32_t pw_step;          ///< Pulse falling edge increment per sample
+    uint32_t gain_remaining;  ///< Samples left in the level ramp (0 when idle)
+    float gain_target;        ///< Gain at the end of the level ramp
+    float gain_step;          ///< Gain increment per sample
+} osc_ramp_t;
 
 /**
- * @brief Initializes the waveform generator with the specified sample rate.
+ * @brief State of one oscillator instance.
+ *
+ * Fields are ordered hot to cold: the phase is touched every sample, the next fields once
+ * per block, and the modulation slots only when they are enabled. The derived values are
+ * cached and only recomputed for the parameters flagged in dirty, so a block with unchanged
+ * parameters starts rendering without any setup arithmetic. Changes of level, pulse width and
+ * pitch glide to the new value over the smoothing times set with osc_set_smoothing().
+ */
+typedef struct
+{
+    uint32_t phase;         ///< Current phase (Q32, one full cycle per 2^32, wraps on overflow)
+    OscWaveform_t waveform; ///< Waveform type (sine, triangle, saw, square, pulse)
+    uint16_t level;         ///< Output level (0–65535)
+    uint16_t pulse_width;   ///< Pulse width for pulse wave (0–65535)
+    int16_t freq_fine;      ///< Fine frequency adjustment in cents (-100 to 100)
+    uint8_t freq_pitch;     ///< MIDI note number (0–127)
+    uint8_t amp_mod_slot;   ///< Amplitude modulation slot (0–15 or 0xFF)
+    uint8_t freq_mod_slot;  ///< Frequency modulation slot (0–15 or 0xFF)
+    uint8_t sync_slot;      ///< Sync source slot (0–15 or 0xFF)
+    uint8_t dirty;          ///< OSC_DIRTY_* flags of parameters changed since derived was computed
+    float sync_prev;        ///< Last sync input value, for rising-edge detection across blocks
+    osc_derived_t derived;  ///< Cached values derived from the parameters
+    osc_ramp_t ramp;        ///< Smoothing ramps in progress
+} osc_t;
+
+/**
+ * @brief Builds the lookup tables shared by all oscillator instances.
  * @param sample_rate The audio sample rate in Hz (e.g., 44100).
  */
 void waveform_init(uint32_t sample_rate);
 
 /**
- * @brief Sets the parameters for waveform generation.
+ * @brief Initializes an oscillator instance with default parameters and zero phase.
+ * @param osc The oscillator to initialize.
+ *
+ * Parameter changes are applied as steps until osc_set_smoothing() is called.
+ */
+void osc_init(osc_t *osc);
+
+/**
+ * @brief Sets the smoothing times of an oscillator instance.
+ * @param osc The oscillator to update.
+ * @param pitch_ms Glide time for pitch and fine tune changes (0 for a step).
+ * @param level_ms Ramp time for level changes (0 for a step).
+ * @param pw_ms Ramp time for pulse width changes (0 for a step).
+ *
+ * Ramps already in progress keep their length; the new times apply from the next change.
+ */
+void osc_set_smoothing(osc_t *osc, uint16_t pitch_ms, uint16_t level_ms, uint16_t pw_ms);
+
+/**
+ * @brief Sets the parameters of an oscillator instance.
+ * @param osc The oscillator to update.
  * @param freq_pitch MIDI note number for frequency (0–127).
  * @param freq_fine Fine frequency adjustment in cents (-100 to 100).
  * @param waveform Waveform type (sine, triangle, saw, square, pulse).
@@ -25,14 +135,40 @@ void waveform_init(uint32_t sample_rate);
  * @param amp_slot Amplitude modulation slot (0–15 or 0xFF for none).
  * @param freq_slot Frequency modulation slot (0–15 or 0xFF for none).
  * @param sync Sync source slot (0–15 or 0xFF for none).
+ *
+ * Only parameters whose value actually changes are flagged for recomputation, so calling this
+ * every block with the same values costs a few comparisons.
+ */
+void osc_set_params(osc_t *osc, uint8_t freq_pitch, int16_t freq_fine, OscWaveform_t waveform, uint16_t level, uint16_t pw, uint8_t amp_slot, uint8_t freq_slot, uint8_t sync);
+
+/**
+ * @brief Sets the TDM modulation input used by the following render calls.
+ * @param slots De-interleaved slot samples, slot s starting at slots + s * stride, or NULL for none.
+ * @param stride Samples per slot; render calls may cover at most this many samples.
  */
-void waveform_set_params(uint8_t freq_pitch, int16_t freq_fine, OscWaveform_t waveform, uint16_t level, uint16_t pw, uint8_t amp_slot, uint8_t freq_slot, uint8_t sync);
+void waveform_set_mod_input(const int16_t *slots, uint32_t stride);
 
 /**
- * @brief Generates a buffer of waveform samples.
+ * @brief Renders a buffer of float samples from an oscillator instance, with gain applied.
+ * @param osc The oscillator to render.
+ * @param out Output samples in 16-bit full scale, ready to mix with osc_post_mix_f32().
+ * @param num_samples Number of samples to generate.
+ */
+void osc_render_f32(osc_t *osc, float *out, uint32_t num_samples);
+
+/**
+ * @brief Renders a buffer of samples from an oscillator instance.
+ * @param osc The oscillator to render.
  * @param buffer Pointer to the output buffer for 16-bit samples.
  * @param num_samples Number of samples to generate.
  */
-void waveform_generate(int16_t *buffer, uint32_t num_samples);
+void osc_render(osc_t *osc, int16_t *buffer, uint32_t num_samples);
+
+#ifdef CONFIG_OSC_KERNEL_BENCHMARK
+/**
+ * @brief Measures and logs the cycles per sample of every render kernel.
+ */
+void osc_benchmark_kernels(void);
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,110 @@
+/**
+ * @file bench_kernels.c
+ * @brief Host benchmark of the Q32 render kernels against the original float-phase generator.
+ *
+ * Renders every waveform in blocks of the firmware DMA size with both generators and prints
+ * the time per sample and the speedup. Host timings only show relative cost; the cycle counts
+ * that matter are logged on the target by CONFIG_OSC_KERNEL_BENCHMARK.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "waveform_gen.h"
+#include "baseline_waveform.h"
+
+/** @brief Audio sample rate (Hz). */
+#define SAMPLE_RATE 44100
+
+/** @brief Samples per block, matching the default I2S DMA frame count. */
+#define BENCH_BLOCK 64
+
+/** @brief Number of blocks rendered per measurement. */
+#define BENCH_BLOCKS 20000
+
+/** @brief Number of measurements per generator; the fastest is reported. */
+#define BENCH_RUNS 5
+
+/** @brief Names of the waveforms, indexed by OscWaveform_t. */
+static const char *wave_names[] = {"sine", "triangle", "saw", "square", "pulse"};
+
+/** @brief Output of the last block, read back so the renders are not optimized away. */
+static volatile int16_t sink;
+
+/**
+ * @brief Returns a monotonic timestamp.
+ * @return double Time in nanoseconds.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Times the original float-phase generator on one waveform.
+ * @param wave Waveform to render.
+ * @return double Best time per sample in nanoseconds.
+ */
+static double bench_baseline(OscWaveform_t wave)
+{
+    int16_t buffer[BENCH_BLOCK];
+    double best = 0.0;
+    baseline_waveform_set_params(57, 0, wave, 65535, 16384, 0xFF, 0xFF, 0xFF);
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        double start = now_ns();
+        for (int b = 0; b < BENCH_BLOCKS; b++)
+            baseline_waveform_generate(buffer, BENCH_BLOCK);
+        double t = (now_ns() - start) / ((double)BENCH_BLOCKS * BENCH_BLOCK);
+        best = run == 0 || t < best ? t : best;
+        sink = buffer[BENCH_BLOCK - 1];
+    }
+    return best;
+}
+
+/**
+ * @brief Times the Q32 kernels, including the post stage, on one waveform.
+ * @param wave Waveform to render.
+ * @return double Best time per sample in nanoseconds.
+ */
+static double bench_q32(OscWaveform_t wave)
+{
+    int16_t buffer[BENCH_BLOCK];
+    double best = 0.0;
+    osc_t osc;
+    osc_init(&osc);
+    osc_set_params(&osc, 57, 0, wave, 65535, 16384, 0xFF, 0xFF, 0xFF);
+    for (int run = 0; run < BENCH_RUNS; run++)
+    {
+        double start = now_ns();
+        for (int b = 0; b < BENCH_BLOCKS; b++)
+            osc_render(&osc, buffer, BENCH_BLOCK);
+        double t = (now_ns() - start) / ((double)BENCH_BLOCKS * BENCH_BLOCK);
+        best = run == 0 || t < best ? t : best;
+        sink = buffer[BENCH_BLOCK - 1];
+    }
+    return best;
+}
+
+int main(void)
+{
+    baseline_waveform_init(SAMPLE_RATE);
+    waveform_init(SAMPLE_RATE);
+#if defined(CONFIG_OSC_ENGINE_NAIVE)
+    printf("engine: naive\n");
+#elif defined(CONFIG_OSC_ENGINE_WAVETABLE)
+    printf("engine: wavetable\n");
+#else
+    printf("engine: polyblep\n");
+#endif
+    printf("%-10s %14s %14s %9s\n", "waveform", "float ns/smp", "q32 ns/smp", "speedup");
+    for (int wave = OSC_WAVE_SINE; wave <= OSC_WAVE_PULSE; wave++)
+    {
+        double base = bench_baseline((OscWaveform_t)wave);
+        double q32 = bench_q32((OscWaveform_t)wave);
+        printf("%-10s %14.2f %14.2f %8.2fx\n", wave_names[wave], base, q32, base / q32);
+    }
+    return 0;
+}
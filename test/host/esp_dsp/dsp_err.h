@@ -0,0 +1,18 @@
+/**
+ * @file dsp_err.h
+ * @brief Host stand-in for the esp-dsp error codes.
+ */
+
+#ifndef DSP_ERR_H
+#define DSP_ERR_H
+
+/** @brief esp-dsp result code. */
+typedef int esp_err_t;
+
+/** @brief Success. */
+#define ESP_OK 0
+
+/** @brief Invalid argument. */
+#define ESP_ERR_DSP_PARAM_OUTOFRANGE 0x70002
+
+#endif
@@ -0,0 +1,27 @@
+/**
+ * @file dsps_add.h
+ * @brief Host stand-in for the esp-dsp element-wise add, bound to its ANSI C version as on targets without an assembly kernel.
+ */
+
+#ifndef DSPS_ADD_H
+#define DSPS_ADD_H
+
+#include "dsp_err.h"
+
+/**
+ * @brief Adds two arrays element by element: output[i * step_out] = input1[i * step1] + input2[i * step2].
+ * @param input1 First input.
+ * @param input2 Second input.
+ * @param output Output samples.
+ * @param len Number of samples.
+ * @param step1 First input stride.
+ * @param step2 Second input stride.
+ * @param step_out Output stride.
+ * @return esp_err_t ESP_OK, or ESP_ERR_DSP_PARAM_OUTOFRANGE for a NULL buffer.
+ */
+esp_err_t dsps_add_f32_ansi(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out);
+
+/** @brief Selects the implementation, as the real header does per target. */
+#define dsps_add_f32 dsps_add_f32_ansi
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file dsps_host.c
+ * @brief Host stand-in for the esp-dsp ANSI C kernels used by osc_post.c, following the upstream loops.
+ */
+
+#include <stddef.h>
+#include "dsps_mulc.h"
+#include "dsps_mul.h"
+#include "dsps_add.h"
+
+esp_err_t dsps_mulc_f32_ansi(const float *input, float *output, int len, float C, int step_in, int step_out)
+{
+    if (NULL == input || NULL == output)
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    for (int i = 0; i < len; i++)
+        output[i * step_out] = input[i * step_in] * C;
+    return ESP_OK;
+}
+
+esp_err_t dsps_mul_f32_ansi(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out)
+{
+    if (NULL == input1 || NULL == input2 || NULL == output)
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    for (int i = 0; i < len; i++)
+        output[i * step_out] = input1[i * step1] * input2[i * step2];
+    return ESP_OK;
+}
+
+esp_err_t dsps_add_f32_ansi(const float *input1, const float *input2, float *output, int len, int step1, int step2, int step_out)
+{
+    if (NULL == input1 || NULL == input2 || NULL == output)
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    for (int i = 0; i < len; i++)
+        output[i * step_out] = input1[i * step1] + input2[i * step2];
+    return ESP_OK;
+}
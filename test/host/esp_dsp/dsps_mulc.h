@@ -0,0 +1,26 @@
+/**
+ * @file dsps_mulc.h
+ * @brief Host stand-in for the esp-dsp constant multiply, bound to its ANSI C version as on targets without an assembly kernel.
+ */
+
+#ifndef DSPS_MULC_H
+#define DSPS_MULC_H
+
+#include "dsp_err.h"
+
+/**
+ * @brief Multiplies every sample by a constant: output[i * step_out] = input[i * step_in] * C.
+ * @param input Input samples.
+ * @param output Output samples.
+ * @param len Number of samples.
+ * @param C Constant.
+ * @param step_in Input stride.
+ * @param step_out Output stride.
+ * @return esp_err_t ESP_OK, or ESP_ERR_DSP_PARAM_OUTOFRANGE for a NULL buffer.
+ */
+esp_err_t dsps_mulc_f32_ansi(const float *input, float *output, int len, float C, int step_in, int step_out);
+
+/** @brief Selects the implementation, as the real header does per target. */
+#define dsps_mulc_f32 dsps_mulc_f32_ansi
+
+#endif
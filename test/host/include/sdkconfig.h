@@ -0,0 +1,16 @@
+/**
+ * @file sdkconfig.h
+ * @brief Host stand-in for the generated sdkconfig.h.
+ *
+ * The engine and the esp-dsp switch are set per target by CMakeLists.txt; the polyBLEP default
+ * matches Kconfig.
+ */
+
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+#if !defined(CONFIG_OSC_ENGINE_NAIVE) && !defined(CONFIG_OSC_ENGINE_POLYBLEP) && !defined(CONFIG_OSC_ENGINE_WAVETABLE)
+#define CONFIG_OSC_ENGINE_POLYBLEP 1
+#endif
+
+#endif
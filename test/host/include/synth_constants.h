@@ -0,0 +1,21 @@
+/**
+ * @file synth_constants.h
+ * @brief Host stand-in for the common_definitions header, providing only what the oscillator DSP code uses.
+ */
+
+#ifndef SYNTH_CONSTANTS_H
+#define SYNTH_CONSTANTS_H
+
+/**
+ * @brief Oscillator waveform types, in the order used on the I2C wire.
+ */
+typedef enum
+{
+    OSC_WAVE_SINE,
+    OSC_WAVE_TRIANGLE,
+    OSC_WAVE_SAW,
+    OSC_WAVE_SQUARE,
+    OSC_WAVE_PULSE,
+} OscWaveform_t;
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file naive_engine.c
+ * @brief Naive synthesis engine wrapper; built with waveform_gen.c under renamed symbols by CMakeLists.txt.
+ *
+ * osc_t differs between engines, so it never crosses this interface: callers built for
+ * another engine only see plain parameters and float samples.
+ */
+
+#include "naive_engine.h"
+#include "waveform_gen.h"
+
+/**
+ * @brief Builds the naive engine's lookup tables.
+ * @param sample_rate The audio sample rate in Hz (e.g., 44100).
+ */
+void naive_engine_init(uint32_t sample_rate)
+{
+    waveform_init(sample_rate);
+}
+
+/**
+ * @brief Renders a waveform with the naive engine from zero phase, at full level and without smoothing.
+ * @param pitch MIDI note number (0–127).
+ * @param fine Fine frequency adjustment in cents (-100 to 100).
+ * @param wave Waveform type.
+ * @param pw Pulse width for pulse wave (0–65535).
+ * @param out Output samples in 16-bit full scale.
+ * @param num_samples Number of samples to generate.
+ */
+void naive_engine_render(uint8_t pitch, int16_t fine, OscWaveform_t wave, uint16_t pw, float *out, uint32_t num_samples)
+{
+    osc_t osc;
+    osc_init(&osc);
+    osc_set_params(&osc, pitch, fine, wave, 65535, pw, 0xFF, 0xFF, 0xFF);
+    osc_render_f32(&osc, out, num_samples);
+}
@@ -0,0 +1,29 @@
+/**
+ * @file naive_engine.h
+ * @brief Header file for the naive synthesis engine built under its own names, so tests can run it next to another engine.
+ */
+
+#ifndef NAIVE_ENGINE_H
+#define NAIVE_ENGINE_H
+
+#include <stdint.h>
+#include "synth_constants.h"
+
+/**
+ * @brief Builds the naive engine's lookup tables.
+ * @param sample_rate The audio sample rate in Hz (e.g., 44100).
+ */
+void naive_engine_init(uint32_t sample_rate);
+
+/**
+ * @brief Renders a waveform with the naive engine from zero phase, at full level and without smoothing.
+ * @param pitch MIDI note number (0–127).
+ * @param fine Fine frequency adjustment in cents (-100 to 100).
+ * @param wave Waveform type.
+ * @param pw Pulse width for pulse wave (0–65535).
+ * @param out Output samples in 16-bit full scale.
+ * @param num_samples Number of samples to generate.
+ */
+void naive_engine_render(uint8_t pitch, int16_t fine, OscWaveform_t wave, uint16_t pw, float *out, uint32_t num_samples);
+
+#endif
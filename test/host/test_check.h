@@ -0,0 +1,42 @@
+/**
+ * @file test_check.h
+ * @brief Minimal check macros shared by the host tests; a test program exits non-zero if any check failed.
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+/** @brief Number of failed checks in this test program. */
+static int test_failures;
+
+/** @brief Number of checks run in this test program. */
+static int test_checks;
+
+/** @brief Records a check, printing the formatted message if it fails. */
+#define CHECK(cond, ...)                                     \
+    do                                                       \
+    {                                                        \
+        test_checks++;                                       \
+        if (!(cond))                                         \
+        {                                                    \
+            test_failures++;                                 \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);      \
+            printf(__VA_ARGS__);                             \
+            printf("\n");                                    \
+        }                                                    \
+    } while (0)
+
+/**
+ * @brief Prints the summary line of a test program.
+ * @param name Name of the test program.
+ * @return int Exit status: 0 if every check passed, 1 otherwise.
+ */
+static inline int test_report(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+    return test_failures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file test_osc_post.c
+ * @brief Host test: the esp-dsp build of the post stage matches the scalar build bit for bit.
+ *
+ * osc_post.c is compiled twice, once with CONFIG_OSC_POST_ESP_DSP against the esp-dsp kernels
+ * and once without; CMakeLists.txt renames the esp-dsp copy to dsp_osc_post_*. Both run on
+ * the same blocks of every length up to 67 samples, in place and out of place.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "osc_post.h"
+#include "test_check.h"
+
+void dsp_osc_post_scale_f32(const float *in, float *out, uint32_t num_samples, float gain);
+float dsp_osc_post_ramp_f32(const float *in, float *out, uint32_t num_samples, float gain, float step);
+void dsp_osc_post_mul_f32(const float *a, const float *b, float *out, uint32_t num_samples);
+void dsp_osc_post_mix_f32(const float *a, const float *b, float *out, uint32_t num_samples);
+void dsp_osc_post_to_s16(const float *in, int16_t *out, uint32_t num_samples);
+
+/** @brief Longest block tested; not a multiple of four, to cover the unrolled tails. */
+#define MAX_LEN 67
+
+/** @brief State of the test signal generator. */
+static uint32_t rng_state = 0x12345678u;
+
+/**
+ * @brief Returns a pseudo-random sample in 16-bit full scale, sometimes beyond it.
+ * @return float Sample between -40000 and 40000.
+ */
+static float random_sample(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return ((float)(int32_t)rng_state / 2147483648.0f) * 40000.0f;
+}
+
+/**
+ * @brief Fills a block with pseudo-random samples.
+ * @param dst Destination.
+ * @param n Number of samples.
+ */
+static void fill_random(float *dst, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+        dst[i] = random_sample();
+}
+
+/**
+ * @brief Compares the esp-dsp and scalar float stages on one block length.
+ * @param n Block length.
+ */
+static void test_float_stages(uint32_t n)
+{
+    float a[MAX_LEN] __attribute__((aligned(16))) = {0};
+    float b[MAX_LEN] __attribute__((aligned(16))) = {0};
+    float ref[MAX_LEN] __attribute__((aligned(16)));
+    float dsp[MAX_LEN] __attribute__((aligned(16)));
+    fill_random(a, n);
+    fill_random(b, n);
+    float gain = 0.37f;
+
+    osc_post_scale_f32(a, ref, n, gain);
+    dsp_osc_post_scale_f32(a, dsp, n, gain);
+    CHECK(memcmp(ref, dsp, n * sizeof(float)) == 0, "scale differs at length %u", (unsigned)n);
+
+    osc_post_mul_f32(a, b, ref, n);
+    dsp_osc_post_mul_f32(a, b, dsp, n);
+    CHECK(memcmp(ref, dsp, n * sizeof(float)) == 0, "mul differs at length %u", (unsigned)n);
+
+    osc_post_mix_f32(a, b, ref, n);
+    dsp_osc_post_mix_f32(a, b, dsp, n);
+    CHECK(memcmp(ref, dsp, n * sizeof(float)) == 0, "mix differs at length %u", (unsigned)n);
+
+    float g_ref = osc_post_ramp_f32(a, ref, n, gain, 0.001f);
+    float g_dsp = dsp_osc_post_ramp_f32(a, dsp, n, gain, 0.001f);
+    CHECK(memcmp(ref, dsp, n * sizeof(float)) == 0 && g_ref == g_dsp, "ramp differs at length %u", (unsigned)n);
+
+    // In place, as osc_render_run() calls them
+    memcpy(ref, a, n * sizeof(float));
+    memcpy(dsp, a, n * sizeof(float));
+    osc_post_mul_f32(ref, b, ref, n);
+    dsp_osc_post_mul_f32(dsp, b, dsp, n);
+    osc_post_scale_f32(ref, ref, n, gain);
+    dsp_osc_post_scale_f32(dsp, dsp, n, gain);
+    CHECK(memcmp(ref, dsp, n * sizeof(float)) == 0, "in-place mul+scale differs at length %u", (unsigned)n);
+}
+
+/**
+ * @brief Compares the 16-bit conversion of both builds and checks it saturates and truncates.
+ * @param n Block length.
+ */
+static void test_to_s16(uint32_t n)
+{
+    float in[MAX_LEN] = {0};
+    int16_t ref[MAX_LEN], dsp[MAX_LEN];
+    fill_random(in, n);
+    osc_post_to_s16(in, ref, n);
+    dsp_osc_post_to_s16(in, dsp, n);
+    CHECK(memcmp(ref, dsp, n * sizeof(int16_t)) == 0, "to_s16 differs at length %u", (unsigned)n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float v = in[i] > 32767.0f ? 32767.0f : (in[i] < -32768.0f ? -32768.0f : in[i]);
+        CHECK(ref[i] == (int16_t)truncf(v), "to_s16(%f) = %d at length %u", (double)in[i], ref[i], (unsigned)n);
+    }
+}
+
+/**
+ * @brief Checks the 16-bit conversion on the saturation and rounding edge cases.
+ */
+static void test_to_s16_edges(void)
+{
+    static const float in[] = {32767.0f, 32767.9f, 32768.0f, 1e9f, -32768.0f, -32768.9f, -1e9f, 1.9f, -1.9f, 0.0f};
+    static const int16_t expect[] = {32767, 32767, 32767, 32767, -32768, -32768, -32768, 1, -1, 0};
+    const uint32_t n = sizeof(in) / sizeof(in[0]);
+    int16_t out[sizeof(in) / sizeof(in[0])];
+    osc_post_to_s16(in, out, n);
+    for (uint32_t i = 0; i < n; i++)
+        CHECK(out[i] == expect[i], "to_s16(%f) = %d, expected %d", (double)in[i], out[i], expect[i]);
+}
+
+int main(void)
+{
+    for (uint32_t n = 0; n <= MAX_LEN; n++)
+    {
+        test_float_stages(n);
+        test_to_s16(n);
+    }
+    test_to_s16_edges();
+    return test_report("test_osc_post");
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_phase.c
+ * @brief Host test of the Q32 phase accumulator against the original float-phase generator.
+ *
+ * The naive engine renders sine and saw exactly as the baseline defines them, so both
+ * generators are run side by side at several pitches and every sample is compared. The
+ * tolerances cover what the baseline itself gets wrong, not the Q32 engine: its sine reads
+ * the table without interpolation (up to one table step, 2π/1024 × 32767 ≈ 201) and its
+ * float phase drifts by a few milliradians over TEST_SAMPLES. Saw samples whose ideal phase is
+ * within TEST_EDGE_GUARD of the wrap are skipped, since that drift can put the two generators
+ * on opposite sides of the discontinuity.
+ *
+ * baseline_waveform.c is included directly so each comparison can restart its phase at zero.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "baseline_waveform.c"
+#include "waveform_gen.h"
+#include "test_check.h"
+
+/** @brief Samples compared per pitch. */
+#define TEST_SAMPLES 4096
+
+/** @brief Block length of both generators. */
+#define TEST_BLOCK 64
+
+/** @brief Largest sine difference, in 16-bit steps: one baseline table step plus phase drift. */
+#define TEST_SINE_TOLERANCE 256
+
+/** @brief Largest saw difference, in 16-bit steps, from the baseline's phase drift. */
+#define TEST_SAW_TOLERANCE 32
+
+/** @brief Saw samples this close to the wrap (in cycles) are not compared. */
+#define TEST_EDGE_GUARD 1e-3
+
+/** @brief Pitches compared: MIDI note and fine tune. */
+static const struct
+{
+    uint8_t pitch;
+    int16_t fine;
+} test_pitches[] = {
+    {33, 0},
+    {57, -37},
+    {69, 0},
+    {81, 50},
+    {96, 100},
+};
+
+/**
+ * @brief Renders a waveform with both generators and checks every sample against the tolerance.
+ * @param wave Waveform (sine or saw).
+ * @param pitch MIDI note number.
+ * @param fine Fine tune in cents.
+ * @param tolerance Largest allowed difference in 16-bit steps.
+ */
+static void test_wave(OscWaveform_t wave, uint8_t pitch, int16_t fine, int tolerance)
+{
+    static int16_t q32[TEST_SAMPLES], ref[TEST_SAMPLES];
+    osc_t osc;
+    osc_init(&osc);
+    osc_set_params(&osc, pitch, fine, wave, 65535, 32768, 0xFF, 0xFF, 0xFF);
+    phase = 0.0f;
+    baseline_waveform_set_params(pitch, fine, wave, 65535, 32768, 0xFF, 0xFF, 0xFF);
+    for (int i = 0; i < TEST_SAMPLES; i += TEST_BLOCK)
+    {
+        osc_render(&osc, q32 + i, TEST_BLOCK);
+        baseline_waveform_generate(ref + i, TEST_BLOCK);
+    }
+    double cycles_per_sample = 440.0 * pow(2.0, (pitch - 69 + fine / 100.0) / 12.0) / SAMPLE_RATE;
+    int worst = 0, worst_at = 0;
+    for (int i = 0; i < TEST_SAMPLES; i++)
+    {
+        double ph = fmod(i * cycles_per_sample, 1.0);
+        if (wave == OSC_WAVE_SAW && (ph < TEST_EDGE_GUARD || ph > 1.0 - TEST_EDGE_GUARD))
+            continue;
+        int diff = abs(q32[i] - ref[i]);
+        if (diff > worst)
+        {
+            worst = diff;
+            worst_at = i;
+        }
+    }
+    CHECK(worst <= tolerance, "%s at pitch %u%+d is %d steps from the baseline at sample %d (tolerance %d)",
+          wave == OSC_WAVE_SINE ? "sine" : "saw", pitch, fine, worst, worst_at, tolerance);
+}
+
+int main(void)
+{
+    waveform_init(SAMPLE_RATE);
+    baseline_waveform_init(SAMPLE_RATE);
+    for (size_t p = 0; p < sizeof(test_pitches) / sizeof(test_pitches[0]); p++)
+    {
+        test_wave(OSC_WAVE_SINE, test_pitches[p].pitch, test_pitches[p].fine, TEST_SINE_TOLERANCE);
+        test_wave(OSC_WAVE_SAW, test_pitches[p].pitch, test_pitches[p].fine, TEST_SAW_TOLERANCE);
+    }
+    return test_report("test_phase");
+}
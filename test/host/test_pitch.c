@@ -0,0 +1,47 @@
+/**
+ * @file test_pitch.c
+ * @brief Host test of the generated pitch tables against the powf() pitch math they replace.
+ *
+ * For every MIDI note and every fine tune from -100 to +100 cents, the phase increment the
+ * oscillator settles on must match 440 × 2^((note - 69 + cents / 100) / 12) Hz computed with
+ * powf(), within TEST_PPM. At note 0, whose increment is only about 800 000, the table's
+ * rounding of the note increment (0.6 ppm) and the truncation of the fine-tune product
+ * (1.3 ppm) add up with powf()'s own error (0.4 ppm); 2.5 ppm is 0.004 cents, far below
+ * anything audible.
+ */
+
+#include <math.h>
+#include "waveform_gen.h"
+#include "test_check.h"
+
+/** @brief Audio sample rate (Hz). */
+#define SAMPLE_RATE 44100
+
+/** @brief Largest relative increment error accepted (parts per million). */
+#define TEST_PPM 2.5
+
+int main(void)
+{
+    waveform_init(SAMPLE_RATE);
+    double worst = 0.0;
+    for (int pitch = 0; pitch <= 127; pitch++)
+    {
+        for (int fine = -100; fine <= 100; fine++)
+        {
+            float sample;
+            osc_t osc;
+            osc_init(&osc);
+            osc_set_params(&osc, (uint8_t)pitch, (int16_t)fine, OSC_WAVE_SINE, 65535, 32768, 0xFF, 0xFF, 0xFF);
+            osc_render_f32(&osc, &sample, 1);
+            float semitones = (float)(pitch - 69) + (float)fine / 100.0f;
+            double expected = 440.0f * powf(2.0f, semitones / 12.0f) / SAMPLE_RATE * 4294967296.0;
+            double ppm = fabs(osc.derived.inc / expected - 1.0) * 1e6;
+            if (ppm > worst)
+                worst = ppm;
+            CHECK(ppm <= TEST_PPM, "pitch %d%+d: increment %u is %.2f ppm from powf's %.1f", pitch, fine,
+                  (unsigned)osc.derived.inc, ppm, expected);
+        }
+    }
+    printf("largest increment error %.3f ppm\n", worst);
+    return test_report("test_pitch");
+}
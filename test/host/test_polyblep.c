@@ -0,0 +1,173 @@
+/**
+ * @file test_polyblep.c
+ * @brief Host test of the PolyBLEP/PolyBLAMP engine against the naive engine.
+ *
+ * Shape: PolyBLEP only corrects the samples within one phase increment of a discontinuity, so
+ * every other sample must equal the naive engine's exactly, the corrected samples must stay
+ * within half a step of the naive ones, and the output must not overshoot full scale.
+ *
+ * Aliasing: at high pitches the harmonics of the naive waveforms fold back below Nyquist onto
+ * frequencies that are not harmonics of the fundamental. The energy in those bins, outside a
+ * few bins around each true harmonic of a Hann-windowed spectrum, must be at least
+ * TEST_ALIAS_GAIN_DB lower with PolyBLEP than without. The naive triangle has no steps and
+ * its harmonics fall as 1/h², so it aliases far less to begin with and PolyBLAMP is held to
+ * the smaller TEST_ALIAS_GAIN_TRIANGLE_DB.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include "waveform_gen.h"
+#include "naive_engine.h"
+#include "test_check.h"
+#include "test_spectrum.h"
+
+/** @brief Audio sample rate (Hz). */
+#define SAMPLE_RATE 44100
+
+/** @brief Samples rendered per comparison; also the FFT length. */
+#define TEST_SAMPLES 4096
+
+/** @brief Pulse width of the pulse tests (25 %). */
+#define TEST_PW 16384
+
+/** @brief Bins on each side of a harmonic counted as that harmonic (Hann main lobe plus leakage). */
+#define TEST_HARMONIC_BINS 4
+
+/** @brief Required reduction of the aliased energy relative to the naive engine (dB); measured 15 dB or more. */
+#define TEST_ALIAS_GAIN_DB 12.0
+
+/** @brief Required reduction of the aliased energy of the triangle (dB); measured 5.6 dB or more. */
+#define TEST_ALIAS_GAIN_TRIANGLE_DB 4.0
+
+/** @brief Names of the waveforms, indexed by OscWaveform_t. */
+static const char *wave_names[] = {"sine", "triangle", "saw", "square", "pulse"};
+
+/** @brief Pitches of the shape tests. */
+static const uint8_t shape_pitches[] = {45, 69, 93, 110};
+
+/** @brief Pitches of the aliasing tests, high enough for folded harmonics to matter. */
+static const uint8_t alias_pitches[] = {93, 100, 105};
+
+/**
+ * @brief Renders a waveform with the PolyBLEP engine from zero phase, at full level and without smoothing.
+ * @param pitch MIDI note number.
+ * @param wave Waveform.
+ * @param out Output samples.
+ * @return uint32_t Phase increment of the oscillator (Q32).
+ */
+static uint32_t render_polyblep(uint8_t pitch, OscWaveform_t wave, float *out)
+{
+    osc_t osc;
+    osc_init(&osc);
+    osc_set_params(&osc, pitch, 0, wave, 65535, TEST_PW, 0xFF, 0xFF, 0xFF);
+    osc_render_f32(&osc, out, TEST_SAMPLES);
+    return osc.derived.inc;
+}
+
+/**
+ * @brief Reports whether a phase is within two increments of one of a waveform's discontinuities.
+ * @param wave Waveform.
+ * @param phase Phase (Q32).
+ * @param inc Phase increment (Q32).
+ * @return bool True if PolyBLEP may correct the sample.
+ */
+static bool near_edge(OscWaveform_t wave, uint32_t phase, uint32_t inc)
+{
+    uint32_t edges[2] = {0, wave == OSC_WAVE_PULSE ? (uint32_t)TEST_PW << 16 : 0x80000000u};
+    int count = wave == OSC_WAVE_SAW ? 1 : 2;
+    for (int e = 0; e < count; e++)
+    {
+        if ((uint32_t)(phase - edges[e] + 2 * inc) < 4 * inc)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Compares the PolyBLEP waveform with the naive one sample by sample.
+ * @param wave Waveform.
+ * @param pitch MIDI note number.
+ */
+static void test_shape(OscWaveform_t wave, uint8_t pitch)
+{
+    static float blep[TEST_SAMPLES], naive[TEST_SAMPLES];
+    uint32_t inc = render_polyblep(pitch, wave, blep);
+    naive_engine_render(pitch, 0, wave, TEST_PW, naive, TEST_SAMPLES);
+    int away_diffs = 0, corrected = 0;
+    float worst_edge = 0.0f, peak = 0.0f;
+    uint32_t phase = 0;
+    for (int i = 0; i < TEST_SAMPLES; i++, phase += inc)
+    {
+        float diff = fabsf(blep[i] - naive[i]);
+        if (fabsf(blep[i]) > peak)
+            peak = fabsf(blep[i]);
+        if (!near_edge(wave, phase, inc))
+            away_diffs += diff != 0.0f;
+        else if (diff > worst_edge)
+            worst_edge = diff;
+        corrected += diff != 0.0f;
+    }
+    CHECK(away_diffs == 0, "%s at pitch %u: %d samples away from the edges differ from the naive engine",
+          wave_names[wave], pitch, away_diffs);
+    CHECK(corrected > 0, "%s at pitch %u: no sample was corrected", wave_names[wave], pitch);
+    // A step of 2 full scale is corrected by at most half of it on each side
+    CHECK(worst_edge <= 32767.0f * 1.001f, "%s at pitch %u: edge correction of %.0f exceeds half a step",
+          wave_names[wave], pitch, (double)worst_edge);
+    CHECK(peak <= 32767.0f * 1.001f, "%s at pitch %u overshoots to %.0f", wave_names[wave], pitch, (double)peak);
+}
+
+/**
+ * @brief Measures the energy that does not belong to a harmonic of the fundamental.
+ * @param out Rendered samples.
+ * @param inc Phase increment of the rendering (Q32).
+ * @return double Aliased energy in dB relative to the total.
+ */
+static double alias_db(const float *out, uint32_t inc)
+{
+    static double power[TEST_SAMPLES / 2 + 1];
+    test_power_spectrum(out, power, TEST_SAMPLES);
+    double f0_bin = (double)inc / 4294967296.0 * TEST_SAMPLES;
+    double total = 0.0, alias = 0.0;
+    for (uint32_t k = 1; k <= TEST_SAMPLES / 2; k++)
+    {
+        double h = round(k / f0_bin);
+        bool harmonic = h >= 1.0 && fabs(k - h * f0_bin) <= TEST_HARMONIC_BINS;
+        total += power[k];
+        if (!harmonic && k > TEST_HARMONIC_BINS)
+            alias += power[k];
+    }
+    return 10.0 * log10(alias / total);
+}
+
+/**
+ * @brief Checks PolyBLEP lowers the aliased energy of a waveform at a pitch.
+ * @param wave Waveform.
+ * @param pitch MIDI note number.
+ */
+static void test_aliasing(OscWaveform_t wave, uint8_t pitch)
+{
+    static float blep[TEST_SAMPLES], naive[TEST_SAMPLES];
+    uint32_t inc = render_polyblep(pitch, wave, blep);
+    naive_engine_render(pitch, 0, wave, TEST_PW, naive, TEST_SAMPLES);
+    double blep_db = alias_db(blep, inc);
+    double naive_db = alias_db(naive, inc);
+    printf("%-8s pitch %3u: aliased energy %6.1f dB naive, %6.1f dB PolyBLEP\n", wave_names[wave], pitch, naive_db,
+           blep_db);
+    double gain_db = wave == OSC_WAVE_TRIANGLE ? TEST_ALIAS_GAIN_TRIANGLE_DB : TEST_ALIAS_GAIN_DB;
+    CHECK(blep_db <= naive_db - gain_db, "%s at pitch %u: aliasing only fell from %.1f to %.1f dB",
+          wave_names[wave], pitch, naive_db, blep_db);
+}
+
+int main(void)
+{
+    waveform_init(SAMPLE_RATE);
+    naive_engine_init(SAMPLE_RATE);
+    for (int wave = OSC_WAVE_TRIANGLE; wave <= OSC_WAVE_PULSE; wave++)
+    {
+        for (size_t p = 0; p < sizeof(shape_pitches); p++)
+            test_shape((OscWaveform_t)wave, shape_pitches[p]);
+        for (size_t p = 0; p < sizeof(alias_pitches); p++)
+            test_aliasing((OscWaveform_t)wave, alias_pitches[p]);
+    }
+    return test_report("test_polyblep");
+}
@@ -0,0 +1,179 @@
+/**
+ * @file test_ramps.c
+ * @brief Host test of the smoothing ramps of one synthesis engine.
+ *
+ * waveform_gen.c is included directly so the test can reach osc_update_derived() and the
+ * ramp state. Every test renders through osc_render_f32() in blocks that do not divide the
+ * ramp length and checks the ramp moves towards its target and lands exactly on it.
+ */
+
+#include "waveform_gen.c"
+#include <string.h>
+#include "test_check.h"
+
+/** @brief Smoothing time of every ramp in the tests (ms). */
+#define TEST_SMOOTH_MS 5
+
+/** @brief Block length of the ramp tests; deliberately not a divisor of the ramp lengths. */
+#define TEST_RAMP_BLOCK 37
+
+/**
+ * @brief Returns the phase increment the oscillator settles on for a pitch.
+ * @param pitch MIDI note number.
+ * @param fine Fine tune in cents.
+ * @return uint32_t Phase increment (Q32).
+ */
+static uint32_t expected_inc(uint8_t pitch, int16_t fine)
+{
+    return (uint32_t)(((uint64_t)note_inc_table[pitch] * cents_ratio_table[fine - PITCH_TABLE_FINE_MIN]) >>
+                      PITCH_TABLE_RATIO_BITS);
+}
+
+/**
+ * @brief Creates an oscillator settled on a parameter set, with no ramp in progress and TEST_SMOOTH_MS smoothing.
+ * @param osc The oscillator.
+ * @param wave Waveform.
+ * @param pitch MIDI note number.
+ * @param level Output level.
+ * @param pw Pulse width.
+ */
+static void settled_osc(osc_t *osc, OscWaveform_t wave, uint8_t pitch, uint16_t level, uint16_t pw)
+{
+    osc_init(osc);
+    osc_set_smoothing(osc, TEST_SMOOTH_MS, TEST_SMOOTH_MS, TEST_SMOOTH_MS);
+    osc_set_params(osc, pitch, 0, wave, level, pw, 0xFF, 0xFF, 0xFF);
+    osc_update_derived(osc);
+}
+
+/**
+ * @brief Checks the level ramp moves monotonically and lands exactly on the new gain.
+ */
+static void test_level_ramp(void)
+{
+    float out[TEST_RAMP_BLOCK];
+    osc_t osc;
+    settled_osc(&osc, OSC_WAVE_SQUARE, 69, 65535, 32768);
+    osc_set_params(&osc, 69, 0, OSC_WAVE_SQUARE, 1000, 32768, 0xFF, 0xFF, 0xFF);
+    float target = 1000.0f / 65535.0f;
+    float prev = osc.derived.gain;
+    uint32_t rendered = 0;
+    while (rendered < osc.ramp.gain_samples)
+    {
+        osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+        rendered += TEST_RAMP_BLOCK;
+        if (osc.ramp.gain_remaining)
+            CHECK(osc.derived.gain < prev && osc.derived.gain > target, "level ramp left its range: %f", (double)osc.derived.gain);
+        prev = osc.derived.gain;
+    }
+    CHECK(osc.ramp.gain_remaining == 0 && osc.derived.gain == target, "level ramp ended at %.9f, expected %.9f",
+          (double)osc.derived.gain, (double)target);
+    // Once landed, the output matches an oscillator that was always at the new level
+    osc_t settled;
+    float ref[TEST_RAMP_BLOCK];
+    settled_osc(&settled, OSC_WAVE_SQUARE, 69, 1000, 32768);
+    settled.phase = osc.phase;
+    osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+    osc_render_f32(&settled, ref, TEST_RAMP_BLOCK);
+    CHECK(memcmp(out, ref, sizeof(out)) == 0, "output after the level ramp differs from a settled oscillator");
+}
+
+/**
+ * @brief Checks a level change during a ramp restarts from the current gain and lands on the latest target.
+ */
+static void test_level_retarget(void)
+{
+    float out[TEST_RAMP_BLOCK];
+    osc_t osc;
+    settled_osc(&osc, OSC_WAVE_SAW, 69, 0, 32768);
+    osc_set_params(&osc, 69, 0, OSC_WAVE_SAW, 65535, 32768, 0xFF, 0xFF, 0xFF);
+    osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+    float midway = osc.derived.gain;
+    osc_set_params(&osc, 69, 0, OSC_WAVE_SAW, 20000, 32768, 0xFF, 0xFF, 0xFF);
+    osc_render_f32(&osc, out, 1);
+    CHECK(fabsf(osc.derived.gain - midway) < 0.01f, "retargeted level ramp jumped from %f to %f", (double)midway,
+          (double)osc.derived.gain);
+    for (uint32_t rendered = 1; rendered < osc.ramp.gain_samples; rendered += TEST_RAMP_BLOCK)
+        osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+    CHECK(osc.ramp.gain_remaining == 0 && osc.derived.gain == 20000.0f / 65535.0f, "retargeted level ramp ended at %f",
+          (double)osc.derived.gain);
+}
+
+/**
+ * @brief Checks the pulse width ramp lands exactly on the new falling edge.
+ */
+static void test_pw_ramp(void)
+{
+    float out[TEST_RAMP_BLOCK];
+    osc_t osc;
+    settled_osc(&osc, OSC_WAVE_PULSE, 69, 65535, 8000);
+    osc_set_params(&osc, 69, 0, OSC_WAVE_PULSE, 65535, 60000, 0xFF, 0xFF, 0xFF);
+    uint32_t prev = osc.derived.pw_threshold;
+    for (uint32_t rendered = 0; rendered < osc.ramp.pw_samples; rendered += TEST_RAMP_BLOCK)
+    {
+        osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+        CHECK(osc.derived.pw_threshold > prev, "pulse width ramp did not rise: %08x", (unsigned)osc.derived.pw_threshold);
+        prev = osc.derived.pw_threshold;
+    }
+    CHECK(osc.ramp.pw_remaining == 0 && osc.derived.pw_threshold == (uint32_t)60000 << 16,
+          "pulse width ramp ended at %08x", (unsigned)osc.derived.pw_threshold);
+}
+
+/**
+ * @brief Checks the pitch glide rises steadily, is one step from the target before landing and lands exactly.
+ */
+static void test_pitch_ramp(void)
+{
+    float out[TEST_RAMP_BLOCK];
+    osc_t osc;
+    settled_osc(&osc, OSC_WAVE_SAW, 57, 65535, 32768);
+    osc_set_params(&osc, 69, 50, OSC_WAVE_SAW, 65535, 32768, 0xFF, 0xFF, 0xFF);
+    uint32_t target = expected_inc(69, 50);
+    uint32_t prev = osc.derived.inc;
+    uint32_t rendered = 0;
+    for (; rendered + TEST_RAMP_BLOCK < osc.ramp.inc_samples; rendered += TEST_RAMP_BLOCK)
+    {
+        osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+        CHECK(osc.derived.inc > prev && osc.derived.inc < target, "pitch glide left its range: %u", (unsigned)osc.derived.inc);
+        prev = osc.derived.inc;
+    }
+    osc_render_f32(&osc, out, osc.ramp.inc_samples - rendered - 1);
+    CHECK(fabs((double)osc.derived.inc * osc.ramp.inc_ratio / target - 1.0) < 1e-4,
+          "pitch glide is at %u, more than one step from %u", (unsigned)osc.derived.inc, (unsigned)target);
+    osc_render_f32(&osc, out, TEST_RAMP_BLOCK);
+    CHECK(osc.ramp.inc_remaining == 0 && osc.derived.inc == target, "pitch glide ended at %u, expected %u",
+          (unsigned)osc.derived.inc, (unsigned)target);
+}
+
+/**
+ * @brief Checks OSC_DIRTY_SNAP applies new values immediately without starting ramps.
+ */
+static void test_snap(void)
+{
+    osc_t osc;
+    settled_osc(&osc, OSC_WAVE_PULSE, 57, 65535, 8000);
+    osc_set_params(&osc, 69, 0, OSC_WAVE_PULSE, 1000, 60000, 0xFF, 0xFF, 0xFF);
+    osc.dirty |= OSC_DIRTY_SNAP;
+    osc_update_derived(&osc);
+    CHECK(osc.ramp.inc_remaining == 0 && osc.ramp.pw_remaining == 0 && osc.ramp.gain_remaining == 0,
+          "snap started a ramp");
+    CHECK(osc.derived.inc == expected_inc(69, 0) && osc.derived.pw_threshold == (uint32_t)60000 << 16 &&
+              osc.derived.gain == 1000.0f / 65535.0f,
+          "snap did not apply the new values");
+}
+
+int main(void)
+{
+    waveform_init(SAMPLE_RATE);
+    test_level_ramp();
+    test_level_retarget();
+    test_pw_ramp();
+    test_pitch_ramp();
+    test_snap();
+#if defined(CONFIG_OSC_ENGINE_NAIVE)
+    return test_report("test_ramps (naive)");
+#elif defined(CONFIG_OSC_ENGINE_WAVETABLE)
+    return test_report("test_ramps (wavetable)");
+#else
+    return test_report("test_ramps (polyblep)");
+#endif
+}
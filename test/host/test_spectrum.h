@@ -0,0 +1,74 @@
+/**
+ * @file test_spectrum.h
+ * @brief Spectrum helpers shared by the host tests: an in-place radix-2 FFT and a Hann window.
+ */
+
+#ifndef TEST_SPECTRUM_H
+#define TEST_SPECTRUM_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * @brief Computes an in-place forward FFT.
+ * @param re Real parts, replaced by the real parts of the spectrum.
+ * @param im Imaginary parts, replaced by the imaginary parts of the spectrum.
+ * @param n Number of points, a power of two.
+ */
+static inline void test_fft(double *re, double *im, uint32_t n)
+{
+    for (uint32_t i = 1, j = 0; i < n; i++)
+    {
+        uint32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+        if (i < j)
+        {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+    for (uint32_t len = 2; len <= n; len <<= 1)
+    {
+        double ang = -2.0 * M_PI / len;
+        for (uint32_t i = 0; i < n; i += len)
+        {
+            for (uint32_t k = 0; k < len / 2; k++)
+            {
+                double wr = cos(ang * k), wi = sin(ang * k);
+                double xr = re[i + k + len / 2] * wr - im[i + k + len / 2] * wi;
+                double xi = re[i + k + len / 2] * wi + im[i + k + len / 2] * wr;
+                re[i + k + len / 2] = re[i + k] - xr;
+                im[i + k + len / 2] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Computes the power spectrum of a block of samples through a Hann window.
+ * @param in Input samples.
+ * @param power Receives the power of bins 0 to n / 2.
+ * @param n Number of samples, a power of two no larger than 8192.
+ */
+static inline void test_power_spectrum(const float *in, double *power, uint32_t n)
+{
+    static double re[8192], im[8192];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        re[i] = in[i] * (0.5 - 0.5 * cos(2.0 * M_PI * i / n));
+        im[i] = 0.0;
+    }
+    test_fft(re, im, n);
+    for (uint32_t k = 0; k <= n / 2; k++)
+        power[k] = re[k] * re[k] + im[k] * im[k];
+}
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file test_wavetable.c
+ * @brief Host test that the mipmapped wavetables never play band content above Nyquist.
+ *
+ * For every note and a spread of fine tunings, the two mipmap levels and the blend the engine
+ * selects are read back and the table it actually plays, (1 - blend) × tab_lo + blend × tab_hi,
+ * is analysed with an FFT over one table period. Harmonic h of the table sounds at h times the
+ * phase increment, so every harmonic at or above half a cycle per sample must be silent: its
+ * amplitude must stay below TEST_ALIAS_LSB, the 16-bit quantisation floor of the tables. The
+ * fundamental must still be present, so a silent or wrongly selected table cannot pass.
+ */
+
+#include <math.h>
+#include "waveform_gen.h"
+#include "test_check.h"
+#include "test_spectrum.h"
+
+/** @brief Audio sample rate (Hz). */
+#define SAMPLE_RATE 44100
+
+/** @brief Entries per table period. */
+#define TEST_TABLE_SIZE 1024
+
+/** @brief Largest amplitude allowed for a harmonic above Nyquist, in 16-bit steps (-90 dBFS). */
+#define TEST_ALIAS_LSB 1.0
+
+/** @brief Smallest fundamental amplitude accepted, in 16-bit steps. */
+#define TEST_FUNDAMENTAL_MIN 16384.0
+
+/** @brief Names of the waveforms, indexed by OscWaveform_t. */
+static const char *wave_names[] = {"sine", "triangle", "saw", "square", "pulse"};
+
+/** @brief Fine tunings checked for every note, covering the whole octave between two notes. */
+static const int16_t test_fines[] = {-100, -67, -33, 0, 33, 67, 100};
+
+/**
+ * @brief Checks the table played at one pitch has no harmonic above Nyquist.
+ * @param wave Waveform.
+ * @param pitch MIDI note number.
+ * @param fine Fine tune in cents.
+ */
+static void test_pitch(OscWaveform_t wave, uint8_t pitch, int16_t fine)
+{
+    static double re[TEST_TABLE_SIZE], im[TEST_TABLE_SIZE];
+    float sample;
+    osc_t osc;
+    osc_init(&osc);
+    osc_set_params(&osc, pitch, fine, wave, 65535, 32768, 0xFF, 0xFF, 0xFF);
+    osc_render_f32(&osc, &sample, 1);
+    const osc_derived_t *d = &osc.derived;
+    for (int i = 0; i < TEST_TABLE_SIZE; i++)
+    {
+        re[i] = (1.0 - d->blend) * d->tab_lo[i] + d->blend * d->tab_hi[i];
+        im[i] = 0.0;
+    }
+    test_fft(re, im, TEST_TABLE_SIZE);
+    double cycles_per_sample = (double)d->inc / 4294967296.0;
+    double worst = 0.0;
+    int worst_h = 0;
+    for (int h = 1; h <= TEST_TABLE_SIZE / 2; h++)
+    {
+        if (h * cycles_per_sample < 0.5)
+            continue;
+        double amp = 2.0 * hypot(re[h], im[h]) / TEST_TABLE_SIZE;
+        if (amp > worst)
+        {
+            worst = amp;
+            worst_h = h;
+        }
+    }
+    double fundamental = 2.0 * hypot(re[1], im[1]) / TEST_TABLE_SIZE;
+    CHECK(worst < TEST_ALIAS_LSB, "%s at pitch %u%+d plays harmonic %d above Nyquist at %.2f steps",
+          wave_names[wave], pitch, fine, worst_h, worst);
+    CHECK(fundamental > TEST_FUNDAMENTAL_MIN, "%s at pitch %u%+d has a fundamental of only %.0f steps",
+          wave_names[wave], pitch, fine, fundamental);
+}
+
+int main(void)
+{
+    waveform_init(SAMPLE_RATE);
+    // Pulse plays the saw tables, so checking saw covers it
+    for (int wave = OSC_WAVE_SINE; wave <= OSC_WAVE_SQUARE; wave++)
+        for (int pitch = 0; pitch <= 127; pitch++)
+            for (size_t f = 0; f < sizeof(test_fines) / sizeof(test_fines[0]); f++)
+                test_pitch((OscWaveform_t)wave, (uint8_t)pitch, test_fines[f]);
+    return test_report("test_wavetable");
+}